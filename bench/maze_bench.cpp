@@ -0,0 +1,224 @@
+// Maze generation benchmark (no GL): times generateMaze(), generateBackroomsMaze() and
+// generateChunk() over every chunk of a grid, from 75x75 up to 8192x8192, over several seeds.
+// Reports cells/s, peak RSS and heap allocations per run, then the time split across the
+// generation passes (mazes, rooms, pillar rooms, polygon rooms, corridors).
+//   maze_bench [maxSize] [seed] [seedCount]
+#include "MazeGenerator.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <vector>
+
+#ifdef __linux__
+#include <fstream>
+#include <string>
+#elif !defined(_WIN32)
+#include <sys/resource.h>
+#endif
+
+// Heap accounting: every scalar/array new in the process goes through here. Each block carries
+// its size in a header so frees can be subtracted from the live total.
+namespace
+{
+  struct HeapCounters
+  {
+    size_t allocations = 0;
+    size_t allocatedBytes = 0;
+    size_t liveBytes = 0;
+    size_t peakLiveBytes = 0;
+  };
+  HeapCounters heap;
+
+  const size_t HEADER_SIZE = alignof(std::max_align_t);
+
+  void *countedAlloc(size_t size)
+  {
+    void *block = std::malloc(size + HEADER_SIZE);
+    if (!block)
+      throw std::bad_alloc();
+    *static_cast<size_t *>(block) = size;
+    heap.allocations++;
+    heap.allocatedBytes += size;
+    heap.liveBytes += size;
+    heap.peakLiveBytes = std::max(heap.peakLiveBytes, heap.liveBytes);
+    return static_cast<char *>(block) + HEADER_SIZE;
+  }
+
+  void countedFree(void *pointer)
+  {
+    if (!pointer)
+      return;
+    void *block = static_cast<char *>(pointer) - HEADER_SIZE;
+    heap.liveBytes -= *static_cast<size_t *>(block);
+    std::free(block);
+  }
+}
+
+void *operator new(size_t size) { return countedAlloc(size); }
+void *operator new[](size_t size) { return countedAlloc(size); }
+void operator delete(void *pointer) noexcept { countedFree(pointer); }
+void operator delete[](void *pointer) noexcept { countedFree(pointer); }
+void operator delete(void *pointer, size_t) noexcept { countedFree(pointer); }
+void operator delete[](void *pointer, size_t) noexcept { countedFree(pointer); }
+
+// Peak resident set size in bytes. Linux can reset the high-water mark, so each run reports its
+// own peak; elsewhere the value is the process-wide peak so far (0 where unavailable).
+static void resetPeakRss()
+{
+#ifdef __linux__
+  std::ofstream clearRefs("/proc/self/clear_refs");
+  clearRefs << "5";
+#endif
+}
+
+static size_t peakRss()
+{
+#ifdef __linux__
+  std::ifstream status("/proc/self/status");
+  std::string line;
+  while (std::getline(status, line))
+  {
+    if (line.compare(0, 6, "VmHWM:") == 0)
+      return std::strtoull(line.c_str() + 6, nullptr, 10) * 1024;
+  }
+  return 0;
+#elif !defined(_WIN32)
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+  return static_cast<size_t>(usage.ru_maxrss);
+#else
+  return static_cast<size_t>(usage.ru_maxrss) * 1024;
+#endif
+#else
+  return 0;
+#endif
+}
+
+enum BenchCase
+{
+  CASE_MAZE,
+  CASE_BACKROOMS,
+  CASE_CHUNKS,
+  CASE_COUNT
+};
+const char *caseNames[CASE_COUNT] = {"generateMaze", "generateBackroomsMaze", "generateChunk"};
+
+struct RunResult
+{
+  double ms = 0.0;
+  size_t peakRss = 0;
+  size_t allocations = 0;
+  size_t allocatedBytes = 0;
+  size_t peakHeapBytes = 0;
+  MazeGenerator::PassTimings passes;
+};
+
+static RunResult runCase(int benchCase, int size, unsigned int seed)
+{
+  resetPeakRss();
+  HeapCounters before = heap;
+  heap.peakLiveBytes = heap.liveBytes;
+
+  // Construction (allocating the bitplanes) is part of what a caller pays, so it is timed too
+  auto begin = std::chrono::steady_clock::now();
+  MazeGenerator maze(size, size, seed);
+  if (benchCase == CASE_MAZE)
+  {
+    maze.generateMaze();
+  }
+  else if (benchCase == CASE_BACKROOMS)
+  {
+    maze.generateBackroomsMaze();
+  }
+  else
+  {
+    int chunks = (size + MazeGenerator::CHUNK_SIZE - 1) / MazeGenerator::CHUNK_SIZE;
+    for (int chunkZ = 0; chunkZ < chunks; ++chunkZ)
+      for (int chunkX = 0; chunkX < chunks; ++chunkX)
+        maze.generateChunk(chunkX, chunkZ);
+  }
+
+  RunResult result;
+  result.ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+  result.peakRss = peakRss();
+  result.allocations = heap.allocations - before.allocations;
+  result.allocatedBytes = heap.allocatedBytes - before.allocatedBytes;
+  result.peakHeapBytes = heap.peakLiveBytes - before.liveBytes;
+  result.passes = maze.getPassTimings();
+  return result;
+}
+
+int main(int argc, char **argv)
+{
+  int maxSize = argc > 1 ? std::atoi(argv[1]) : 8192;
+  unsigned int seed = argc > 2 ? static_cast<unsigned int>(std::strtoul(argv[2], nullptr, 10)) : 12345u;
+  int seedCount = argc > 3 ? std::max(1, std::atoi(argv[3])) : 3;
+
+  const std::vector<int> sizes = {75, 128, 256, 512, 1024, 2048, 4096, 8192};
+  const double MB = 1024.0 * 1024.0;
+
+  // The generators log each maze they build; keep the table readable
+  std::cout.setstate(std::ios::failbit);
+
+  std::printf("Median of %d seeds from %u; RSS and heap are the largest over the seeds, allocations the mean\n\n",
+              seedCount, seed);
+  std::vector<std::vector<RunResult>> medians(CASE_COUNT);
+  for (int benchCase = 0; benchCase < CASE_COUNT; ++benchCase)
+  {
+    std::printf("%s\n", caseNames[benchCase]);
+    std::printf("%12s %12s %10s %10s %11s %12s %12s %10s\n", "size", "cells", "ms", "Mcells/s",
+                "peak RSS MB", "peak heap MB", "allocations", "alloc MB");
+    for (int size : sizes)
+    {
+      if (size > maxSize)
+        break;
+
+      std::vector<RunResult> runs;
+      for (int i = 0; i < seedCount; ++i)
+        runs.push_back(runCase(benchCase, size, seed + i));
+      std::sort(runs.begin(), runs.end(), [](const RunResult &a, const RunResult &b)
+                { return a.ms < b.ms; });
+
+      RunResult median = runs[runs.size() / 2];
+      size_t allocations = 0, allocatedBytes = 0;
+      for (const RunResult &run : runs)
+      {
+        median.peakRss = std::max(median.peakRss, run.peakRss);
+        median.peakHeapBytes = std::max(median.peakHeapBytes, run.peakHeapBytes);
+        allocations += run.allocations;
+        allocatedBytes += run.allocatedBytes;
+      }
+      median.allocations = allocations / runs.size();
+      median.allocatedBytes = allocatedBytes / runs.size();
+      medians[benchCase].push_back(median);
+
+      double cells = static_cast<double>(size) * size;
+      std::printf("%5dx%-6d %12.0f %10.2f %10.2f %11.2f %12.2f %12zu %10.2f\n", size, size, cells, median.ms,
+                  cells / (median.ms * 1000.0), median.peakRss / MB, median.peakHeapBytes / MB,
+                  median.allocations, median.allocatedBytes / MB);
+    }
+    std::printf("\n");
+  }
+
+  // Where the time goes inside each generator, for the median run of each size
+  std::printf("Pass breakdown (ms)\n");
+  std::printf("%-22s %12s %10s %10s %10s %10s %10s %10s\n", "generator", "size", "total", "mazes", "rooms",
+              "pillars", "polygons", "corridors");
+  for (int benchCase = 0; benchCase < CASE_COUNT; ++benchCase)
+  {
+    for (size_t i = 0; i < medians[benchCase].size(); ++i)
+    {
+      const RunResult &run = medians[benchCase][i];
+      const MazeGenerator::PassTimings &passes = run.passes;
+      std::printf("%-22s %5dx%-6d %10.2f %10.2f %10.2f %10.2f %10.2f %10.2f\n", caseNames[benchCase], sizes[i],
+                  sizes[i], run.ms, passes.mazeMs, passes.roomsMs, passes.pillarRoomsMs, passes.customRoomsMs,
+                  passes.corridorsMs);
+    }
+  }
+  return 0;
+}
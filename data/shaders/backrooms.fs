@@ -7,19 +7,24 @@ in vec2 TexCoord;
 
 uniform sampler2D texture1;
 uniform vec3 objectColor;
-uniform vec3 viewPos;
-uniform float ambientStrength;
 
+// Layout must match FrameUniformData in FrameUniforms.h
 struct Spotlight {
   vec3 position;
-  vec3 direction;
   float cutOff;
+  vec3 direction;
   float outerCutOff;
   vec3 color;
   float intensity;
 };
 
-uniform Spotlight spotlight;
+layout (std140) uniform FrameData {
+  mat4 projection;
+  mat4 view;
+  vec3 viewPos;
+  float ambientStrength;
+  Spotlight spotlight;
+};
 
 void main() {
   vec3 color = texture(texture1, TexCoord).rgb * objectColor;
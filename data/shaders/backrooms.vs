@@ -8,12 +8,30 @@ out vec3 Normal;
 out vec2 TexCoord;
 
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+
+// Layout must match FrameUniformData in FrameUniforms.h
+struct Spotlight {
+  vec3 position;
+  float cutOff;
+  vec3 direction;
+  float outerCutOff;
+  vec3 color;
+  float intensity;
+};
+
+layout (std140) uniform FrameData {
+  mat4 projection;
+  mat4 view;
+  vec3 viewPos;
+  float ambientStrength;
+  Spotlight spotlight;
+};
 
 void main() {
   FragPos = vec3(model * vec4(aPos, 1.0));
-  Normal = mat3(transpose(inverse(model))) * aNormal;
+  // Maze models are yaw rotations with axis-aligned scales that never tilt a normal,
+  // so the upper 3x3 works without the per-vertex inverse
+  Normal = mat3(model) * aNormal;
   TexCoord = aTexCoord;
 
   gl_Position = projection * view * vec4(FragPos, 1.0);
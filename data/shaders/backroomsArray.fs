@@ -0,0 +1,71 @@
+#version 330 core
+out vec4 FragColor;
+
+in vec3 FragPos;
+in vec3 Normal;
+in vec2 TexCoord;
+flat in uint Material;
+
+// Indexed by MazePiece: every material of a baked chunk is drawn in one call
+uniform sampler2DArray materials;
+uniform float materialLayer[4];
+uniform vec3 materialColor[4];
+uniform float materialEmission[4]; // > 0 for unlit light tiles
+
+// Layout must match FrameUniformData in FrameUniforms.h
+struct Spotlight {
+  vec3 position;
+  float cutOff;
+  vec3 direction;
+  float outerCutOff;
+  vec3 color;
+  float intensity;
+};
+
+layout (std140) uniform FrameData {
+  mat4 projection;
+  mat4 view;
+  vec3 viewPos;
+  float ambientStrength;
+  Spotlight spotlight;
+};
+
+void main() {
+  if (materialEmission[Material] > 0.0) {
+    FragColor = vec4(materialColor[Material] * materialEmission[Material], 1.0);
+    return;
+  }
+
+  vec3 color = texture(materials, vec3(TexCoord, materialLayer[Material])).rgb * materialColor[Material];
+  vec3 normal = normalize(Normal);
+
+  vec3 ambient = ambientStrength * vec3(0.9, 0.9, 0.7);
+
+  vec3 spotlightResult = vec3(0.0);
+  if (spotlight.intensity > 0.0) {
+    vec3 lightDir = normalize(spotlight.position - FragPos);
+    float theta = dot(lightDir, normalize(-spotlight.direction));
+    float epsilon = spotlight.cutOff - spotlight.outerCutOff;
+    float intensity = clamp((theta - spotlight.outerCutOff) / epsilon, 0.0, 1.0);
+
+    float diff = max(dot(normal, lightDir), 0.0);
+    vec3 diffuse = diff * spotlight.color;
+
+    float distance = length(spotlight.position - FragPos);
+    float attenuation = 1.0 / (1.0 + 0.09 * distance + 0.032 * (distance * distance));
+
+    spotlightResult = spotlight.intensity * intensity * attenuation * diffuse;
+  }
+
+  float distance = length(viewPos - FragPos);
+  float fogFactor = exp(-distance * 0.02);
+  fogFactor = clamp(fogFactor, 0.1, 1.0);
+
+  vec3 result = ambient + spotlightResult;
+  result = result * color * fogFactor;
+
+  result.r *= 1.1;
+  result.g *= 1.05;
+
+  FragColor = vec4(result, 1.0);
+}
@@ -0,0 +1,41 @@
+#version 330 core
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec3 aNormal;
+layout (location = 2) in vec2 aTexCoord;
+layout (location = 3) in uint aMaterial;
+
+out vec3 FragPos;
+out vec3 Normal;
+out vec2 TexCoord;
+flat out uint Material;
+
+uniform mat4 model;
+
+// Layout must match FrameUniformData in FrameUniforms.h
+struct Spotlight {
+  vec3 position;
+  float cutOff;
+  vec3 direction;
+  float outerCutOff;
+  vec3 color;
+  float intensity;
+};
+
+layout (std140) uniform FrameData {
+  mat4 projection;
+  mat4 view;
+  vec3 viewPos;
+  float ambientStrength;
+  Spotlight spotlight;
+};
+
+void main() {
+  FragPos = vec3(model * vec4(aPos, 1.0));
+  // Maze models are yaw rotations with axis-aligned scales that never tilt a normal,
+  // so the upper 3x3 works without the per-vertex inverse
+  Normal = mat3(model) * aNormal;
+  TexCoord = aTexCoord;
+  Material = aMaterial;
+
+  gl_Position = projection * view * vec4(FragPos, 1.0);
+}
\ No newline at end of file
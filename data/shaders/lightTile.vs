@@ -4,8 +4,24 @@ layout (location = 1) in vec3 aNormal;
 layout (location = 2) in vec2 aTexCoord;
 
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+
+// Layout must match FrameUniformData in FrameUniforms.h
+struct Spotlight {
+  vec3 position;
+  float cutOff;
+  vec3 direction;
+  float outerCutOff;
+  vec3 color;
+  float intensity;
+};
+
+layout (std140) uniform FrameData {
+  mat4 projection;
+  mat4 view;
+  vec3 viewPos;
+  float ambientStrength;
+  Spotlight spotlight;
+};
 
 void main() {
   gl_Position = projection * view * model * vec4(aPos, 1.0);
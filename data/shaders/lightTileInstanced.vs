@@ -0,0 +1,68 @@
+#version 330 core
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec3 aNormal;
+layout (location = 2) in vec2 aTexCoord;
+layout (location = 3) in ivec2 aCell;     // PackedPiece::cellX/cellZ, relative to cellOrigin
+layout (location = 4) in uint aPieceBits; // PackedPiece::bits
+
+// Layout must match FrameUniformData in FrameUniforms.h
+struct Spotlight {
+  vec3 position;
+  float cutOff;
+  vec3 direction;
+  float outerCutOff;
+  vec3 color;
+  float intensity;
+};
+
+layout (std140) uniform FrameData {
+  mat4 projection;
+  mat4 view;
+  vec3 viewPos;
+  float ambientStrength;
+  Spotlight spotlight;
+};
+
+// Draw origin the instances were packed against, in whole cells
+uniform vec2 cellOrigin;
+
+// Geometry constants and PackedPiece bit layout must match MazeGeometry.h
+const float CELL_SIZE = 2.0;
+const float WALL_HEIGHT = 3.5;
+const float CEILING_TILE_SIZE = CELL_SIZE / 2.0;
+const float WALL_SCALE_Y = WALL_HEIGHT / 3.0;
+const uint PIECE_FLOOR = 0u;
+const uint PIECE_WALL = 3u;
+
+// Quarter turns about +Y, same direction as glm::rotate
+vec3 rotateY(vec3 v, uint turns) {
+  if (turns == 1u) return vec3(v.z, v.y, -v.x);
+  if (turns == 2u) return vec3(-v.x, v.y, -v.z);
+  if (turns == 3u) return vec3(-v.z, v.y, v.x);
+  return v;
+}
+
+// Local template vertex -> world space, without building a matrix
+vec3 decodePosition(vec3 localPos) {
+  uint piece = aPieceBits & 3u;
+  uint turns = (aPieceBits >> 2) & 3u;
+  vec3 cellPos = vec3(float(aCell.x) + cellOrigin.x, 0.0, float(aCell.y) + cellOrigin.y) * CELL_SIZE;
+
+  if (piece == PIECE_FLOOR)
+    return cellPos + localPos;
+
+  if (piece == PIECE_WALL) {
+    vec3 inward = rotateY(vec3(0.0, 0.0, 1.0), turns);
+    vec3 origin = cellPos - inward * (CELL_SIZE * 0.5) + vec3(0.0, WALL_HEIGHT * 0.5, 0.0);
+    return origin + rotateY(localPos * vec3(1.0, WALL_SCALE_Y, 1.0), turns);
+  }
+
+  // Ceiling and light tiles: one quarter of the cell, picked by the sub-tile bits
+  vec2 subTile = vec2(float((aPieceBits >> 4) & 1u), float((aPieceBits >> 5) & 1u));
+  vec3 origin = cellPos + vec3((subTile.x - 0.5) * CEILING_TILE_SIZE, WALL_HEIGHT, (subTile.y - 0.5) * CEILING_TILE_SIZE);
+  return origin + localPos * (CEILING_TILE_SIZE / CELL_SIZE);
+}
+
+void main() {
+  gl_Position = projection * view * vec4(decodePosition(aPos), 1.0);
+}
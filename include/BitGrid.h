@@ -0,0 +1,82 @@
+#ifndef BIT_GRID_H
+#define BIT_GRID_H
+
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+#include <vector>
+
+// One bit per cell of a width x height grid. Rows start on a 64-bit word boundary so a row
+// (or a run of cells inside one) can be scanned or filled a word at a time.
+class BitGrid
+{
+public:
+  BitGrid() = default;
+  BitGrid(int width, int height)
+      : width(width), height(height), stride((width + 63) / 64), words(static_cast<size_t>(stride) * height, 0)
+  {
+  }
+
+  bool test(int x, int z) const
+  {
+    return (words[wordIndex(x, z)] >> (x & 63)) & 1u;
+  }
+
+  void set(int x, int z) { words[wordIndex(x, z)] |= bit(x); }
+  void reset(int x, int z) { words[wordIndex(x, z)] &= ~bit(x); }
+  void assign(int x, int z, bool value) { value ? set(x, z) : reset(x, z); }
+
+  // Cells [x0, x1) of row z, whole words at a time between the partial end words
+  void assignSpan(int z, int x0, int x1, bool value)
+  {
+    if (x0 >= x1)
+      return;
+    uint64_t *rowWords = words.data() + static_cast<size_t>(z) * stride;
+    int firstWord = x0 >> 6, lastWord = (x1 - 1) >> 6;
+    uint64_t firstMask = ~uint64_t(0) << (x0 & 63);
+    uint64_t lastMask = ~uint64_t(0) >> (63 - ((x1 - 1) & 63));
+    if (firstWord == lastWord)
+    {
+      assignBits(rowWords[firstWord], firstMask & lastMask, value);
+      return;
+    }
+    assignBits(rowWords[firstWord], firstMask, value);
+    std::fill(rowWords + firstWord + 1, rowWords + lastWord, value ? ~uint64_t(0) : uint64_t(0));
+    assignBits(rowWords[lastWord], lastMask, value);
+  }
+
+  void fill(bool value)
+  {
+    std::fill(words.begin(), words.end(), value ? ~uint64_t(0) : uint64_t(0));
+    if (value)
+      clearPadding();
+  }
+
+  int getWidth() const { return width; }
+  int getHeight() const { return height; }
+  int getWordsPerRow() const { return stride; }
+  const uint64_t *row(int z) const { return words.data() + static_cast<size_t>(z) * stride; }
+  size_t memoryBytes() const { return words.size() * sizeof(uint64_t); }
+
+private:
+  int width = 0;
+  int height = 0;
+  int stride = 0; // 64-bit words per row
+  std::vector<uint64_t> words;
+
+  size_t wordIndex(int x, int z) const { return static_cast<size_t>(z) * stride + (x >> 6); }
+  static uint64_t bit(int x) { return uint64_t(1) << (x & 63); }
+  static void assignBits(uint64_t &word, uint64_t mask, bool value) { word = value ? (word | mask) : (word & ~mask); }
+
+  // Bits past the last column stay zero so whole-row scans need no masking
+  void clearPadding()
+  {
+    if ((width & 63) == 0)
+      return;
+    uint64_t mask = (uint64_t(1) << (width & 63)) - 1;
+    for (int z = 0; z < height; ++z)
+      words[static_cast<size_t>(z) * stride + stride - 1] &= mask;
+  }
+};
+
+#endif
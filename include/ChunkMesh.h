@@ -0,0 +1,85 @@
+#ifndef CHUNK_MESH_H
+#define CHUNK_MESH_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <array>
+#include <vector>
+
+#include "Mesh.h"
+#include "MazeGeometry.h"
+#include "FrustumCuller.h"
+
+// Baked vertex: the Mesh layout plus the MazePiece it belongs to, so texture-array shaders can
+// pick a layer and colour per fragment and draw every material at once
+struct ChunkVertex
+{
+  glm::vec3 Position;
+  glm::vec3 Normal;
+  glm::vec2 TexCoords;
+  unsigned int Material;
+};
+
+// Static geometry of one CHUNK_SIZE x CHUNK_SIZE chunk, pre-transformed to world space.
+// Every chunk lives in the builder's shared vertex/index buffers (so one indirect multi-draw can
+// cover them all); within a chunk, materials are contiguous index ranges in MazePiece order.
+struct ChunkMesh
+{
+  static constexpr unsigned int MATERIAL_ATTRIB_LOCATION = 3;
+
+  int chunkX = 0;
+  int chunkZ = 0;
+  AABB bounds;
+
+  unsigned int VAO = 0;        // shared by all chunks
+  unsigned int firstIndex = 0; // start of this chunk in the shared index buffer
+  int baseVertex = 0;          // added to this chunk's indices
+  std::array<unsigned int, PIECE_COUNT> indexOffset{}; // relative to firstIndex
+  std::array<unsigned int, PIECE_COUNT> indexCount{};
+
+  unsigned int totalIndexCount() const { return indexOffset[PIECE_COUNT - 1] + indexCount[PIECE_COUNT - 1]; }
+
+  // Returns false if the chunk has no geometry of this material
+  bool Draw(MazePiece piece) const;
+  // Every material in one call (for shaders that read the material attribute)
+  bool DrawAll() const;
+};
+
+class ChunkMeshBuilder
+{
+public:
+  // Bake every chunk of the maze. Template meshes supply the local-space quad of each piece.
+  void rebuild(const MazeGenerator &maze, const Mesh &wallMesh, const Mesh &floorMesh, const Mesh &ceilingMesh);
+
+  // Free all GL buffers (call while the context is still current)
+  void release();
+
+  // Merge adjacent coplanar faces into long quads with repeating UVs (takes effect on the next rebuild)
+  void setGreedyMerging(bool enabled) { greedyMerging = enabled; }
+  bool getGreedyMerging() const { return greedyMerging; }
+
+  const std::vector<ChunkMesh> &getChunks() const { return chunks; }
+  unsigned int getVAO() const { return VAO; }
+  size_t getVertexCount() const { return vertexCount; }
+  size_t getTriangleCount() const { return triangleCount; }
+
+private:
+  std::vector<ChunkMesh> chunks;
+  unsigned int VAO = 0, VBO = 0, EBO = 0;
+  size_t vertexCount = 0;
+  size_t triangleCount = 0;
+  bool greedyMerging = true;
+
+  void buildChunk(ChunkMesh &chunk, const MazeGenerator &maze, const std::array<const Mesh *, PIECE_COUNT> &templates);
+  template <typename QuadFn, typename PieceFn>
+  void buildMergedChunk(const MazeGenerator &maze, int startX, int startZ, int w, int h, QuadFn &&appendQuad, PieceFn &&appendPiece);
+  void append(ChunkMesh &chunk, const std::array<std::vector<ChunkVertex>, PIECE_COUNT> &vertices,
+              const std::array<std::vector<unsigned int>, PIECE_COUNT> &indices);
+  void upload();
+
+  // Staging for the shared buffers while rebuilding
+  std::vector<ChunkVertex> allVertices;
+  std::vector<unsigned int> allIndices;
+};
+
+#endif
@@ -0,0 +1,96 @@
+#ifndef CHUNK_STREAMER_H
+#define CHUNK_STREAMER_H
+
+#include <glm/glm.hpp>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "ChunkedWorld.h"
+
+// Keeps the chunks around the camera of a ChunkedWorld resident without generating on the
+// render thread. Worker threads pull the most urgent missing chunk from a queue that is
+// re-prioritised every frame (nearest first, biased towards where the camera looks and moves);
+// finished chunks are handed back and inserted by update(), and the least recently needed
+// chunks are evicted once the world goes over its memory budget.
+class ChunkStreamer
+{
+public:
+  struct Stats
+  {
+    int queued = 0;          // requests waiting for a worker
+    int inFlight = 0;        // chunks being generated right now
+    int completedTotal = 0;  // chunks generated since start()
+    int evictedTotal = 0;    // chunks dropped by the memory budget
+    double generateMs = 0.0; // mean time a worker spends on one chunk
+    double generateMaxMs = 0.0;
+    double latencyMs = 0.0;  // mean time from first request to the chunk being resident
+    double latencyMaxMs = 0.0;
+  };
+
+  ChunkStreamer() = default;
+  ~ChunkStreamer() { stop(); }
+  ChunkStreamer(const ChunkStreamer &) = delete;
+  ChunkStreamer &operator=(const ChunkStreamer &) = delete;
+
+  // threadCount <= 0 picks one per hardware thread, leaving one for the render loop
+  void start(int threadCount = 0);
+  void stop();
+  bool isRunning() const { return !workers.empty(); }
+
+  // Once per frame: takes finished chunks, queues the ones now wanted around `position` and
+  // enforces the memory budget. Only ever waits on a short queue lock, never on generation.
+  void update(ChunkedWorld &world, const glm::vec3 &position, const glm::vec3 &front, const glm::vec3 &velocity);
+
+  // Chunks kept generated around the camera, and how far ahead (along the view direction and
+  // one second of travel) another ring of chunks is prefetched
+  int radius = 2;
+  int prefetchDistance = 2;
+  size_t memoryBudget = 96 * 1024;
+
+  const Stats &getStats() const { return stats; }
+  int getThreadCount() const { return static_cast<int>(workers.size()); }
+
+private:
+  using Clock = std::chrono::steady_clock;
+
+  struct Request
+  {
+    uint64_t key;
+    float priority; // lower is sooner
+  };
+
+  struct Result
+  {
+    uint64_t key;
+    unsigned int seed;
+    WorldChunk chunk;
+    double generateMs;
+  };
+
+  std::vector<std::thread> workers;
+  std::mutex mutex;
+  std::condition_variable wake;
+  bool stopping = false;
+  unsigned int seed = 0;
+
+  // Shared with the workers (guarded by mutex)
+  std::vector<Request> queue; // sorted so the most urgent request is at the back
+  std::unordered_set<uint64_t> inFlight;
+  std::vector<Result> completed;
+
+  // Render thread only
+  std::unordered_map<uint64_t, uint64_t> lastUsedFrame; // every resident chunk, for LRU eviction
+  std::unordered_map<uint64_t, Clock::time_point> requestedAt;
+  uint64_t frame = 0;
+  Stats stats;
+
+  void workerLoop();
+  void evict(ChunkedWorld &world);
+};
+
+#endif
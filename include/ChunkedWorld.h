@@ -0,0 +1,97 @@
+#ifndef CHUNKED_WORLD_H
+#define CHUNKED_WORLD_H
+
+#include <cstdint>
+#include <unordered_map>
+#include "MazeGenerator.h"
+
+// Cells of one CHUNK_SIZE x CHUNK_SIZE chunk of an unbounded world, in the same bitplane
+// layout MazeGenerator uses
+struct WorldChunk
+{
+  BitGrid typeBits[2];
+  BitGrid visitedBits;
+
+  MazeGridView view() const
+  {
+    return MazeGridView(typeBits[0], typeBits[1], visitedBits, 0, 0, typeBits[0].getWidth(), typeBits[0].getHeight());
+  }
+  size_t memoryBytes() const { return typeBits[0].memoryBytes() + typeBits[1].memoryBytes() + visitedBits.memoryBytes(); }
+};
+
+// Unbounded maze addressed by chunk. Every chunk is a pure function of (seed, chunkX, chunkZ),
+// so chunks can be generated, dropped and regenerated in any order and always match their
+// neighbours. Cell coordinates may be negative; cells of chunks that aren't resident read as walls.
+class ChunkedWorld
+{
+public:
+  static const int CHUNK_SIZE = MazeGenerator::CHUNK_SIZE;
+
+  explicit ChunkedWorld(unsigned int seed = 0);
+
+  // Builds chunk (chunkX, chunkZ) of the world with this seed. Touches no shared state, so it
+  // is safe to call from any thread.
+  static WorldChunk generateChunk(unsigned int seed, int chunkX, int chunkZ);
+
+  // Generates missing chunks within `radius` chunks of cell (cellX, cellZ) and drops resident
+  // chunks further away than `keepRadius`
+  void update(int cellX, int cellZ, int radius, int keepRadius);
+
+  const WorldChunk *findChunk(int chunkX, int chunkZ) const;
+  // Returns the chunk, generating it first if it isn't resident
+  const WorldChunk &requireChunk(int chunkX, int chunkZ);
+  void insertChunk(int chunkX, int chunkZ, WorldChunk &&chunk);
+  void removeChunk(int chunkX, int chunkZ);
+  void clear()
+  {
+    chunks.clear();
+    memoryUsage = 0;
+  }
+
+  CellType getCellType(int x, int z) const;
+  bool isWall(int x, int z) const;
+  bool isFloor(int x, int z) const;
+
+  // Calls fn(x, z) for every floor cell of resident chunks inside [x, x + w) x [z, z + h)
+  template <typename Fn>
+  void forEachFloorCell(int x, int z, int w, int h, Fn &&fn) const
+  {
+    for (int cz = chunkCoord(z); cz <= chunkCoord(z + h - 1); ++cz)
+    {
+      for (int cx = chunkCoord(x); cx <= chunkCoord(x + w - 1); ++cx)
+      {
+        const WorldChunk *chunk = findChunk(cx, cz);
+        if (!chunk)
+          continue;
+
+        int originX = cx * CHUNK_SIZE, originZ = cz * CHUNK_SIZE;
+        for (glm::ivec2 cell : chunk->view().subView(x - originX, z - originZ, w, h).floorCells())
+          fn(originX + cell.x, originZ + cell.y);
+      }
+    }
+  }
+
+  // Floor division, so cell -1 belongs to chunk -1 (at local coordinate CHUNK_SIZE - 1)
+  static int chunkCoord(int cell) { return cell >= 0 ? cell / CHUNK_SIZE : (cell + 1) / CHUNK_SIZE - 1; }
+  static int localCoord(int cell) { return cell - chunkCoord(cell) * CHUNK_SIZE; }
+
+  unsigned int getSeed() const { return seed; }
+  size_t getResidentChunks() const { return chunks.size(); }
+  // Bytes used by the cell bitplanes of every resident chunk
+  size_t getMemoryUsage() const { return memoryUsage; }
+
+  // One 64-bit key per chunk coordinate pair (and back)
+  static uint64_t chunkKey(int chunkX, int chunkZ)
+  {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(chunkX)) << 32) | static_cast<uint32_t>(chunkZ);
+  }
+  static int keyChunkX(uint64_t key) { return static_cast<int>(static_cast<uint32_t>(key >> 32)); }
+  static int keyChunkZ(uint64_t key) { return static_cast<int>(static_cast<uint32_t>(key)); }
+
+private:
+  unsigned int seed;
+  std::unordered_map<uint64_t, WorldChunk> chunks;
+  size_t memoryUsage = 0;
+};
+
+#endif
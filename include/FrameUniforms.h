@@ -0,0 +1,55 @@
+#ifndef FRAME_UNIFORMS_H
+#define FRAME_UNIFORMS_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <cstddef>
+
+#include <shader.h>
+
+// CPU mirror of the std140 "FrameData" uniform block declared by every maze shader.
+// vec3 members are paired with a float so each pair fills one 16-byte std140 slot.
+struct SpotlightUniform
+{
+  glm::vec3 position;
+  float cutOff;
+  glm::vec3 direction;
+  float outerCutOff;
+  glm::vec3 color;
+  float intensity;
+};
+
+struct FrameUniformData
+{
+  glm::mat4 projection;
+  glm::mat4 view;
+  glm::vec3 viewPos;
+  float ambientStrength;
+  SpotlightUniform spotlight;
+};
+
+static_assert(sizeof(SpotlightUniform) == 48, "SpotlightUniform must match std140 layout");
+static_assert(offsetof(FrameUniformData, viewPos) == 128, "FrameUniformData must match std140 layout");
+static_assert(offsetof(FrameUniformData, spotlight) == 144, "FrameUniformData must match std140 layout");
+static_assert(sizeof(FrameUniformData) == 192, "FrameUniformData must match std140 layout");
+
+// Uniform buffer holding camera and lighting state, written once per frame and shared by all programs
+class FrameUniformBuffer
+{
+public:
+  static const unsigned int BINDING_POINT = 0;
+  static constexpr const char *BLOCK_NAME = "FrameData";
+
+  void init();
+  void release();
+
+  // Point the program's FrameData block at our binding; programs without the block are ignored
+  void attach(const Shader &shader) const;
+
+  void update(const FrameUniformData &data);
+
+private:
+  unsigned int UBO = 0;
+};
+
+#endif
@@ -4,6 +4,8 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <array>
+#include <cstdint>
+#include <vector>
 
 struct Plane
 {
@@ -36,6 +38,34 @@ struct AABB
   }
 };
 
+// Many boxes stored as one array per coordinate (structure of arrays), so a batch test loads the
+// same coordinate of 4 or 8 consecutive boxes with one instruction
+struct AABBArray
+{
+  std::vector<float> minX, minY, minZ;
+  std::vector<float> maxX, maxY, maxZ;
+
+  size_t size() const { return minX.size(); }
+  void clear()
+  {
+    minX.clear(), minY.clear(), minZ.clear();
+    maxX.clear(), maxY.clear(), maxZ.clear();
+  }
+  void add(const AABB &aabb)
+  {
+    minX.push_back(aabb.min.x), minY.push_back(aabb.min.y), minZ.push_back(aabb.min.z);
+    maxX.push_back(aabb.max.x), maxY.push_back(aabb.max.y), maxZ.push_back(aabb.max.z);
+  }
+};
+
+// Where a box lies relative to the frustum
+enum class FrustumTest
+{
+  OUTSIDE,
+  INTERSECTING,
+  INSIDE
+};
+
 class FrustumCuller
 {
 public:
@@ -47,15 +77,28 @@ public:
   // Test if AABB is inside or intersecting frustum
   bool isAABBVisible(const AABB &aabb) const;
 
+  // Like isAABBVisible, but also tells boxes entirely inside apart from ones crossing a plane
+  FrustumTest classifyAABB(const AABB &aabb) const;
+
+  // Tests every box at once: bit i % 64 of visibleMask[i / 64] is set when box i is inside or
+  // intersecting, exactly as isAABBVisible would say. 8 boxes per step with AVX, 4 with SSE.
+  void isAABBVisibleBatch(const AABBArray &boxes, std::vector<uint64_t> &visibleMask) const;
+
   // Test if point is inside frustum
   bool isPointVisible(const glm::vec3 &point) const;
 
   // Test if sphere is inside or intersecting frustum
   bool isSphereVisible(const glm::vec3 &center, float radius) const;
 
+  // Normalized planes from the last updateFrustum (for uploading to GPU culling)
+  const std::array<Plane, 6> &getPlanes() const { return planes; }
+
 private:
   // 6 planes: left, right, bottom, top, near, far
   std::array<Plane, 6> planes;
+  // Per plane, bits 0/1/2 are set when the normal's x/y/z is >= 0: the box corner furthest along
+  // the normal then takes that coordinate from max, otherwise from min
+  std::array<uint8_t, 6> signMasks;
 
   void extractPlane(const glm::mat4 &matrix, int row, bool negate = false);
 };
@@ -0,0 +1,86 @@
+#ifndef GPU_CULLER_H
+#define GPU_CULLER_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <memory>
+
+#include <shader.h>
+#include "ChunkMesh.h"
+#include "FrustumCuller.h"
+
+// Per-chunk record in the bounds SSBO (std430). Layout must match Chunk in chunkCull.comp.
+struct GpuChunk
+{
+  glm::vec4 boundsMin;
+  glm::vec4 boundsMax;
+  uint32_t firstIndex;
+  uint32_t indexCount;
+  int32_t baseVertex;
+  uint32_t padding;
+};
+
+// Command layout consumed by glMultiDrawElementsIndirect
+struct DrawElementsIndirectCommand
+{
+  uint32_t count;
+  uint32_t instanceCount;
+  uint32_t firstIndex;
+  int32_t baseVertex;
+  uint32_t baseInstance;
+};
+
+static_assert(sizeof(GpuChunk) == 48, "GpuChunk must match the std430 Chunk struct");
+static_assert(sizeof(DrawElementsIndirectCommand) == 20, "DrawElementsIndirectCommand must be tightly packed");
+
+// GL 4.3 chunk culling: bounds live in an SSBO, a compute shader runs the frustum test and writes
+// one indirect command per chunk (instanceCount 0 when culled), and a single
+// glMultiDrawElementsIndirect draws them. The CPU cost no longer depends on the chunk count.
+class GpuCuller
+{
+public:
+  // True if the current context exposes GL 4.3 (compute shaders, SSBOs, multi-draw indirect)
+  static bool isSupported();
+
+  // Returns false if unsupported or the compute shader fails to build
+  bool init();
+  void release();
+  bool isReady() const { return cullShader != nullptr; }
+
+  // Upload chunk bounds and index ranges; call after every ChunkMeshBuilder::rebuild
+  void setChunks(const ChunkMeshBuilder &chunkMeshes);
+
+  // Test every chunk against the XZ render range (and the frustum if testFrustum), filling the indirect buffer
+  void cull(const FrustumCuller &frustum, bool testFrustum, const glm::vec2 &rangeMin, const glm::vec2 &rangeMax);
+
+  // Draw all visible chunks with one call (the caller binds the program and textures)
+  void draw() const;
+
+  int getChunkCount() const { return chunkCount; }
+  // Visible chunks of an earlier frame, read back only once its fence has signalled (-1 until then)
+  int getVisibleCount() const { return visibleCount; }
+
+private:
+  // Counters in flight at once, each read back once its own fence has signalled
+  static constexpr int COUNTER_SLOTS = 3;
+
+  std::unique_ptr<Shader> cullShader;
+  // Compute shader uniforms, resolved in init()
+  UniformHandle planeUniforms[6];
+  UniformHandle testFrustumUniform;
+  UniformHandle chunkCountUniform;
+  UniformHandle rangeUniform;
+  unsigned int chunkBuffer = 0;
+  unsigned int commandBuffer = 0;
+  // One per slot, plus a spare that frames finding every slot still in flight count into unread
+  unsigned int counterBuffers[COUNTER_SLOTS + 1] = {};
+  unsigned int VAO = 0;
+  GLsync counterFences[COUNTER_SLOTS] = {};
+  bool counterFlushed[COUNTER_SLOTS] = {};
+  int nextCounter = 0; // slot the next frame writes, which is also the oldest in flight
+  int chunkCount = 0;
+  int visibleCount = -1;
+};
+
+#endif
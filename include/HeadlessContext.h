@@ -0,0 +1,25 @@
+#ifndef HEADLESS_CONTEXT_H
+#define HEADLESS_CONTEXT_H
+
+// Offscreen OpenGL context for running without a display (e.g. Mesa llvmpipe on a build machine).
+// Uses EGL: a surfaceless Mesa display if available, otherwise a 1x1 pbuffer on the default display.
+// Nothing is presented, so render into a framebuffer object.
+class HeadlessContext
+{
+public:
+  ~HeadlessContext() { destroy(); }
+
+  // Tries a 4.3 core context, then 3.3 core. Returns false if EGL is unavailable or both fail.
+  bool create();
+  void destroy();
+
+  // Loader for gladLoadGLLoader
+  static void *getProcAddress(const char *name);
+
+private:
+  void *display = nullptr;
+  void *context = nullptr;
+  void *surface = nullptr;
+};
+
+#endif
@@ -0,0 +1,38 @@
+#ifndef INSTANCE_BATCH_H
+#define INSTANCE_BATCH_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <vector>
+
+#include "Mesh.h"
+#include "MazeGeometry.h"
+
+// Collects PackedPiece instances for one template Mesh during the frame and submits them
+// with a single glDrawElementsInstanced. The instance buffer is streamed (orphaned and
+// refilled) every frame. Shaders read the cell from location 3 and the piece bits from location 4.
+class InstanceBatch
+{
+public:
+  static const unsigned int INSTANCE_ATTRIB_LOCATION = 3;
+
+  // Create the vertex array sharing mesh's vertex/index buffers (needs a current GL context)
+  void init(const Mesh &mesh);
+  void release();
+
+  void clear() { instances.clear(); }
+  void add(const PackedPiece &piece) { instances.push_back(piece); }
+  size_t size() const { return instances.size(); }
+
+  // Upload this frame's instances and draw them; returns false if there was nothing to draw
+  bool Draw();
+
+private:
+  unsigned int VAO = 0;
+  unsigned int instanceVBO = 0;
+  unsigned int indexCount = 0;
+  size_t capacity = 0;
+  std::vector<PackedPiece> instances;
+};
+
+#endif
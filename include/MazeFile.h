@@ -0,0 +1,83 @@
+#ifndef MAZE_FILE_H
+#define MAZE_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include "BitGrid.h"
+
+// Binary maze file, all integers little-endian:
+//
+//   header     magic "BKMZ", u16 version, u16 header size, u32 width, u32 height, u32 seed,
+//              u32 chunk size, u32 chunks x, u32 chunks z, u64 directory offset      (40 bytes)
+//   directory  chunks x * chunks z entries, row-major: u64 payload offset, u32 payload size,
+//              u8 encoding, 3 bytes padding                                            (16 bytes each)
+//   payloads   one per chunk; cells past the maze edge are stored as zero
+//
+// A cell is 3 bits: its 2-bit CellType plus the visited flag. Each chunk is stored with whichever
+// encoding is smaller:
+//   ENCODING_BITPACKED  the three bitplanes, each chunk-size rows of u16 (96 bytes for 16x16)
+//   ENCODING_RLE        (cell value, run length - 1) byte pairs over the cells in row-major order
+namespace MazeFileFormat
+{
+  const char MAGIC[4] = {'B', 'K', 'M', 'Z'};
+  const uint16_t VERSION = 1;
+  const size_t HEADER_SIZE = 40;
+  const size_t DIRECTORY_ENTRY_SIZE = 16;
+
+  enum Encoding : uint8_t
+  {
+    ENCODING_BITPACKED = 0,
+    ENCODING_RLE = 1
+  };
+
+  struct Header
+  {
+    int width = 0;
+    int height = 0;
+    uint32_t seed = 0;
+    int chunkSize = 0;
+    int chunksX = 0;
+    int chunksZ = 0;
+    uint64_t directoryOffset = 0;
+  };
+}
+
+// A maze file mapped read-only into memory. Opening validates the header and directory but
+// decodes nothing; chunks are decoded one at a time on request.
+class MazeFile
+{
+public:
+  ~MazeFile();
+  MazeFile(const MazeFile &) = delete;
+  MazeFile &operator=(const MazeFile &) = delete;
+
+  // Returns nullptr (and prints why) if the file can't be mapped or isn't a valid maze file
+  static std::shared_ptr<const MazeFile> open(const std::string &path);
+
+  // Writes a maze given as its three bitplanes (CellType low bit, high bit, visited)
+  static bool write(const std::string &path, uint32_t seed, int chunkSize,
+                    const BitGrid &typeLow, const BitGrid &typeHigh, const BitGrid &visited);
+
+  const MazeFileFormat::Header &getHeader() const { return header; }
+
+  // Decodes chunk (chunkX, chunkZ) into the planes at its position, skipping cells outside them
+  bool decodeChunk(int chunkX, int chunkZ, BitGrid &typeLow, BitGrid &typeHigh, BitGrid &visited) const;
+
+private:
+  MazeFile() = default;
+
+  MazeFileFormat::Header header;
+  const uint8_t *data = nullptr;
+  size_t size = 0;
+#ifdef _WIN32
+  void *fileHandle = nullptr;
+  void *mappingHandle = nullptr;
+#endif
+
+  bool map(const std::string &path);
+  bool validate(const std::string &path);
+};
+
+#endif
@@ -2,8 +2,13 @@
 #define MAZE_GENERATOR_H
 
 #include <vector>
+#include <memory>
+#include <string>
 #include <glm/glm.hpp>
 #include <random>
+#include "BitGrid.h"
+
+class MazeFile;
 
 enum class CellType
 {
@@ -13,6 +18,7 @@ enum class CellType
   EMPTY
 };
 
+// Value snapshot of one cell; the generator stores cells bit-packed and builds these on request
 struct MazeCell
 {
   CellType type;
@@ -20,6 +26,170 @@ struct MazeCell
   bool visited = false;
 };
 
+// Read-only window onto a maze's cells that never copies them. Coordinates passed to the
+// accessors are local to the view; floor-cell iteration yields absolute maze coordinates.
+// A view stays valid while its MazeGenerator is alive and not reassigned.
+class MazeGridView
+{
+public:
+  MazeGridView() = default;
+  MazeGridView(const BitGrid &typeLow, const BitGrid &typeHigh, const BitGrid &visited,
+               int originX, int originZ, int width, int height)
+      : typeLow(&typeLow), typeHigh(&typeHigh), visited(&visited),
+        originX(originX), originZ(originZ), width(width), height(height)
+  {
+  }
+
+  int getOriginX() const { return originX; }
+  int getOriginZ() const { return originZ; }
+  int getWidth() const { return width; }
+  int getHeight() const { return height; }
+  bool empty() const { return width <= 0 || height <= 0; }
+
+  bool contains(int x, int z) const { return x >= 0 && x < width && z >= 0 && z < height; }
+
+  // Cells outside the view read as walls, matching MazeGenerator::isWall
+  bool isWall(int x, int z) const
+  {
+    return !contains(x, z) || (!typeLow->test(originX + x, originZ + z) && !typeHigh->test(originX + x, originZ + z));
+  }
+  bool isFloor(int x, int z) const
+  {
+    return contains(x, z) && typeLow->test(originX + x, originZ + z) && !typeHigh->test(originX + x, originZ + z);
+  }
+  CellType getCellType(int x, int z) const
+  {
+    if (!contains(x, z))
+      return CellType::WALL;
+    return static_cast<CellType>(typeLow->test(originX + x, originZ + z) | (typeHigh->test(originX + x, originZ + z) << 1));
+  }
+  MazeCell getCell(int x, int z) const;
+
+  // Word-level row access for scans: each row of the underlying grid is getRowStride() 64-bit
+  // words, and this view's columns are bits [getOriginX(), getOriginX() + getWidth()) of it
+  int getRowStride() const { return typeLow->getWordsPerRow(); }
+  const uint64_t *typeLowRow(int z) const { return typeLow->row(originZ + z); }
+  const uint64_t *typeHighRow(int z) const { return typeHigh->row(originZ + z); }
+
+  // Window of this view, clipped to it
+  MazeGridView subView(int x, int z, int subWidth, int subHeight) const;
+
+  // Forward iterator over the floor cells of the view, row by row, a 64-cell word at a time.
+  // Iterators and ranges hold a copy of the view, so iterating a temporary view is safe.
+  class FloorIterator;
+  struct FloorRange;
+
+  // for (glm::ivec2 cell : view.floorCells()) visits every floor cell without building a list
+  FloorRange floorCells() const;
+
+private:
+  const BitGrid *typeLow = nullptr;
+  const BitGrid *typeHigh = nullptr;
+  const BitGrid *visited = nullptr;
+  int originX = 0, originZ = 0;
+  int width = 0, height = 0;
+};
+
+class MazeGridView::FloorIterator
+{
+public:
+  FloorIterator() = default;
+  FloorIterator(const MazeGridView &view, int z) : view(view), z(z) { loadRow(); }
+
+  glm::ivec2 operator*() const { return glm::ivec2(wordBase + ctz(bits), view.originZ + z); }
+  FloorIterator &operator++()
+  {
+    bits &= bits - 1;
+    if (!bits)
+      advance();
+    return *this;
+  }
+  bool operator==(const FloorIterator &other) const { return z == other.z && bits == other.bits && wordBase == other.wordBase; }
+  bool operator!=(const FloorIterator &other) const { return !(*this == other); }
+
+private:
+  MazeGridView view;
+  int z = 0;
+  int word = 0;     // index within the grid row
+  int wordBase = 0; // absolute x of bit 0 of the current word
+  uint64_t bits = 0;
+
+  static int ctz(uint64_t value)
+  {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(value);
+#else
+    int n = 0;
+    while (!(value & 1))
+    {
+      value >>= 1;
+      ++n;
+    }
+    return n;
+#endif
+  }
+
+  void loadRow()
+  {
+    if (view.empty())
+      z = view.height;
+    if (z >= view.height)
+    {
+      bits = 0;
+      word = wordBase = 0;
+      return;
+    }
+    word = view.originX >> 6;
+    loadWord();
+    if (!bits)
+      advance();
+  }
+
+  void loadWord()
+  {
+    int x0 = view.originX, x1 = view.originX + view.width;
+    wordBase = word << 6;
+    uint64_t floor = view.typeLowRow(z)[word] & ~view.typeHighRow(z)[word];
+    if (wordBase < x0)
+      floor &= ~uint64_t(0) << (x0 - wordBase);
+    if (x1 - wordBase < 64)
+      floor &= (uint64_t(1) << (x1 - wordBase)) - 1;
+    bits = floor;
+  }
+
+  void advance()
+  {
+    const int lastWord = (view.originX + view.width - 1) >> 6;
+    while (!bits)
+    {
+      if (++word > lastWord)
+      {
+        ++z;
+        if (z >= view.height)
+        {
+          bits = 0;
+          word = wordBase = 0;
+          return;
+        }
+        word = view.originX >> 6;
+      }
+      loadWord();
+    }
+  }
+};
+
+struct MazeGridView::FloorRange
+{
+  FloorIterator first, last;
+  FloorIterator begin() const { return first; }
+  FloorIterator end() const { return last; }
+};
+
+inline MazeGridView::FloorRange MazeGridView::floorCells() const
+{
+  return {FloorIterator(*this, 0), FloorIterator(*this, height)};
+}
+
 class MazeGenerator
 {
 public:
@@ -27,41 +197,131 @@ public:
 
   void generateMaze();
   void generateBackroomsMaze(); // New backrooms-style generation
+  // Chunk layout seeded from hash(seed, chunkX, chunkZ) alone: the same cells whatever else has
+  // been generated, in any order. Rooms stay inside the chunk and corridors run along fixed
+  // chunk-local rows/columns, so neighbouring chunks always line up.
   void generateChunk(int chunkX, int chunkZ);
+  // Same layout for chunk (chunkX, chunkZ), written into this grid's chunk slot (slotX, slotZ)
+  void generateChunk(int chunkX, int chunkZ, int slotX, int slotZ);
+  static uint32_t chunkSeed(uint32_t seed, int chunkX, int chunkZ);
 
-  std::vector<MazeCell> getCells() const { return cells; }
+  // Copying accessors; prefer view()/chunkView() for anything that only reads
+  std::vector<MazeCell> getCells() const;
   std::vector<MazeCell> getChunk(int chunkX, int chunkZ) const;
+  MazeCell getCell(int x, int z) const;
+
+  // Non-copying views over the whole grid or one chunk (clipped to the maze bounds)
+  MazeGridView view() const
+  {
+    decodeAll();
+    return gridView();
+  }
+  MazeGridView chunkView(int chunkX, int chunkZ) const;
+
+  // World-space position of a cell (derived from its coordinates, not stored)
+  static glm::vec3 cellPosition(int x, int z) { return glm::vec3(x * 2.0f, 0.0f, z * 2.0f); }
 
   CellType getCellType(int x, int z) const;
   bool isWall(int x, int z) const;
   bool isFloor(int x, int z) const;
   bool isValidCell(int x, int z) const;
 
+  // Calls fn(x, z) for every floor cell in the window [x, x + w) x [z, z + h), clipped to the maze
+  template <typename Fn>
+  void forEachFloorCell(int x, int z, int w, int h, Fn &&fn) const
+  {
+    decodeRegion(x, z, w, h);
+    for (glm::ivec2 cell : gridView().subView(x, z, w, h).floorCells())
+      fn(cell.x, cell.y);
+  }
+
+  // Binary maze file (format in MazeFile.h). load() maps the file and decodes each chunk the
+  // first time any of its cells is read, so huge mazes open without decoding them up front.
+  // Until every chunk has been decoded, reads fill in cells, so a loaded maze must not be read
+  // from several threads at once before then.
+  bool save(const std::string &path) const;
+  bool load(const std::string &path);
+  bool isFullyDecoded() const { return !mazeFile; }
+
   int getWidth() const { return width; }
   int getHeight() const { return height; }
+  // Bytes used by the cell bitplanes
+  size_t getMemoryUsage() const;
+  unsigned int getSeed() const { return seed; }
+
+  // Moves the cell bitplanes out (for owners that keep cells without a generator), leaving this maze empty
+  void releaseCells(BitGrid &typeLow, BitGrid &typeHigh, BitGrid &visited);
 
   static const int CHUNK_SIZE = 16;
 
+  // Wall-clock time spent in each generation pass, summed over every generate call since
+  // construction or resetPassTimings() (read by maze_bench)
+  struct PassTimings
+  {
+    double mazeMs = 0.0;        // generateMaze carving, or the backrooms' overlapping Prim's mazes
+    double roomsMs = 0.0;       // rectangular rooms, including each chunk's room grid
+    double pillarRoomsMs = 0.0;
+    double customRoomsMs = 0.0; // polygon rooms
+    double corridorsMs = 0.0;   // chunk corridors
+  };
+  const PassTimings &getPassTimings() const { return passTimings; }
+  void resetPassTimings() { passTimings = PassTimings(); }
+
 private:
   int width, height;
-  std::vector<MazeCell> cells;
+  // Cell state as bitplanes: the 2-bit CellType (typeBits[0] is the low bit, so WALL is all zero) and visited.
+  // Mutable only so const reads can decode chunks of a loaded file into them.
+  mutable BitGrid typeBits[2];
+  mutable BitGrid visitedBits;
+  unsigned int seed;
   std::mt19937 rng;
 
-  void carvePath(int x, int z);
-  std::vector<glm::ivec2> getNeighbors(int x, int z);
-  int getIndex(int x, int z) const;
+  // Loaded file and which of its chunks are decoded; released once all of them are
+  mutable std::shared_ptr<const MazeFile> mazeFile;
+  mutable BitGrid decodedChunks;
+  mutable int chunksPending = 0;
+
+  PassTimings passTimings;
+
+  MazeGridView gridView() const { return MazeGridView(typeBits[0], typeBits[1], visitedBits, 0, 0, width, height); }
+  void decodeRegion(int x, int z, int w, int h) const;
+  void decodeAll() const
+  {
+    if (mazeFile)
+      decodeRegion(0, 0, width, height);
+  }
+  void discardFile();
+
+  void setCellType(int x, int z, CellType type);
+
+  void carvePath(int startX, int startZ);
 
   // Original backrooms-style generation
-  void generateBackroomsLayout(int chunkX, int chunkZ);
+  void generateBackroomsLayout(int slotX, int slotZ, std::mt19937 &chunkRng);
   void addRandomRooms(int chunkX, int chunkZ);
-  void addCorridors(int chunkX, int chunkZ);
+  void addCorridors(int slotX, int slotZ);
 
   // Exact Python translations
   void generateRooms(int numRooms, int widthMin, int widthMax, int heightMin, int heightMax);
   void generatePillarRooms(int numRooms, int widthMin, int widthMax, int heightMin, int heightMax, int spacingMin, int spacingMax);
   void generateCustomRooms(int numRooms, int minSides, int maxSides, int minRadius, int maxRadius);
   void generateBackroomCorridors();
-  bool isInsideCustomRoom(int x, int z, const std::vector<glm::ivec2> &vertices);
+
+  // A placed room as floor spans [x0, x1) per row, plus (pillar rooms) a wall every
+  // pillarSpacing cells from (pillarX, pillarZ) across the room's bounds
+  struct RoomSpan
+  {
+    int z, x0, x1;
+  };
+  struct RoomStamp
+  {
+    std::vector<RoomSpan> spans;
+    int pillarSpacing = 0;
+    int pillarX = 0, pillarZ = 0;
+  };
+  static void addPolygonSpans(RoomStamp &room, int row, int minX, int maxX, const std::vector<glm::ivec2> &vertices);
+  void fillSpan(int z, int x0, int x1, CellType type, bool visited);
+  void stampRooms(const std::vector<RoomStamp> &rooms);
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,150 @@
+#ifndef MAZE_GEOMETRY_H
+#define MAZE_GEOMETRY_H
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include "MazeGenerator.h"
+#include "FrustumCuller.h"
+
+// Kinds of geometry a floor cell is built from. Each piece maps to one material.
+enum MazePiece
+{
+  PIECE_FLOOR,
+  PIECE_CEILING,
+  PIECE_LIGHT_TILE,
+  PIECE_WALL,
+  PIECE_COUNT
+};
+
+// One piece of maze geometry in 8 bytes. Every piece is a translation, a yaw in quarter turns
+// and a fixed per-type scale, so the grid cell plus a few bits fully describe its transform.
+// The instanced vertex shaders decode this layout directly.
+//
+// cellX/cellZ are 16-bit, so cells are packed relative to a draw origin and must lie within
+// +-32767 cells of it. The fixed maze and baked chunks use origin (0, 0); the per-cell and
+// instanced paths pack around the camera's cell, which keeps the unbounded world in range.
+struct PackedPiece
+{
+  int16_t cellX;
+  int16_t cellZ;
+  uint32_t bits; // [0-1] MazePiece, [2-3] quarter turns about +Y, [4] ceiling sub-tile x, [5] ceiling sub-tile z
+
+  MazePiece piece() const { return static_cast<MazePiece>(bits & 3u); }
+  int turns() const { return static_cast<int>((bits >> 2) & 3u); }
+  int subTileX() const { return static_cast<int>((bits >> 4) & 1u); }
+  int subTileZ() const { return static_cast<int>((bits >> 5) & 1u); }
+
+  static bool inRange(int x, int z) { return x >= INT16_MIN && x <= INT16_MAX && z >= INT16_MIN && z <= INT16_MAX; }
+
+  // x, z relative to the draw origin
+  static PackedPiece pack(MazePiece piece, int x, int z, int turns = 0, int subX = 0, int subZ = 0)
+  {
+    assert(inRange(x, z) && "cell too far from the draw origin for PackedPiece");
+    PackedPiece p;
+    p.cellX = static_cast<int16_t>(x);
+    p.cellZ = static_cast<int16_t>(z);
+    p.bits = static_cast<uint32_t>(piece) | (static_cast<uint32_t>(turns & 3) << 2) |
+             (static_cast<uint32_t>(subX & 1) << 4) | (static_cast<uint32_t>(subZ & 1) << 5);
+    return p;
+  }
+};
+
+static_assert(sizeof(PackedPiece) == 8, "PackedPiece must stay 8 bytes (instance attribute layout)");
+
+// Layout of the maze in world space, shared by every render path so they stay in sync
+namespace MazeGeometry
+{
+  constexpr float CELL_SIZE = 2.0f;
+  constexpr float WALL_HEIGHT = 3.5f;
+  constexpr float CEILING_TILE_SIZE = CELL_SIZE / 2.0f; // 4 ceiling tiles per cell (2x2)
+  constexpr float WALL_OFFSET = CELL_SIZE * 0.5f;
+  constexpr float HALF_WALL_HEIGHT = WALL_HEIGHT / 2.0f;
+  constexpr float WALL_SCALE_Y = WALL_HEIGHT / 3.0f;
+
+  // Every 4th ceiling tile along X and 3rd along Z glows
+  inline bool isLightTile(int globalCeilingX, int globalCeilingZ)
+  {
+    return globalCeilingX % 4 == 0 && globalCeilingZ % 3 == 0;
+  }
+
+  // Full transform of a packed piece, for paths that bake or upload matrices; (originX, originZ) is
+  // the draw origin it was packed against
+  inline glm::mat4 modelMatrix(const PackedPiece &p, int originX = 0, int originZ = 0)
+  {
+    glm::vec3 position((p.cellX + originX) * CELL_SIZE, 0.0f, (p.cellZ + originZ) * CELL_SIZE);
+    glm::mat4 model(1.0f);
+
+    switch (p.piece())
+    {
+    case PIECE_FLOOR:
+      model = glm::translate(model, position);
+      break;
+    case PIECE_CEILING:
+    case PIECE_LIGHT_TILE:
+      model = glm::translate(model, position + glm::vec3((p.subTileX() - 0.5f) * CEILING_TILE_SIZE,
+                                                         WALL_HEIGHT,
+                                                         (p.subTileZ() - 0.5f) * CEILING_TILE_SIZE));
+      model = glm::scale(model, glm::vec3(CEILING_TILE_SIZE / CELL_SIZE));
+      break;
+    default:
+    {
+      // A wall faces into its cell: yaw 0 faces +Z and sits on the cell's -Z edge
+      float yaw = glm::radians(90.0f * p.turns());
+      glm::vec3 inward(glm::sin(yaw), 0.0f, glm::cos(yaw));
+      model = glm::translate(model, position - inward * WALL_OFFSET + glm::vec3(0.0f, HALF_WALL_HEIGHT, 0.0f));
+      if (p.turns() != 0)
+        model = glm::rotate(model, yaw, glm::vec3(0.0f, 1.0f, 0.0f));
+      model = glm::scale(model, glm::vec3(1.0f, WALL_SCALE_Y, 1.0f));
+      break;
+    }
+    }
+    return model;
+  }
+
+  // The cell a world position is in: cell c spans [c - 0.5, c + 0.5) cell sizes on each axis, as in
+  // Player's collision test. Every render path and visibility window centres on this.
+  inline glm::ivec2 cameraCell(const glm::vec3 &position)
+  {
+    return glm::ivec2(static_cast<int>(std::floor(position.x / CELL_SIZE + 0.5f)),
+                      static_cast<int>(std::floor(position.z / CELL_SIZE + 0.5f)));
+  }
+
+  inline AABB cellBounds(int x, int z)
+  {
+    return AABB(glm::vec3(x * CELL_SIZE - CELL_SIZE * 0.5f, 0.0f, z * CELL_SIZE - CELL_SIZE * 0.5f),
+                glm::vec3(x * CELL_SIZE + CELL_SIZE * 0.5f, WALL_HEIGHT, z * CELL_SIZE + CELL_SIZE * 0.5f));
+  }
+
+  // Calls fn(const PackedPiece &) for the floor, the 2x2 ceiling tiles and every wall bordering floor cell (x, z),
+  // packed relative to (originX, originZ). Maze is anything with isWall(x, z) (MazeGenerator, ChunkedWorld).
+  template <typename Maze, typename Fn>
+  void forEachCellPiece(const Maze &maze, int x, int z, Fn &&fn, int originX = 0, int originZ = 0)
+  {
+    const int packX = x - originX, packZ = z - originZ;
+    fn(PackedPiece::pack(PIECE_FLOOR, packX, packZ));
+
+    for (int cz = 0; cz < 2; ++cz)
+    {
+      for (int cx = 0; cx < 2; ++cx)
+      {
+        bool light = isLightTile((x * 2) + cx, (z * 2) + cz);
+        fn(PackedPiece::pack(light ? PIECE_LIGHT_TILE : PIECE_CEILING, packX, packZ, 0, cx, cz));
+      }
+    }
+
+    // North (+Z), South (-Z), East (+X), West (-X), each turned to face back into the cell
+    const int dx[4] = {0, 0, 1, -1};
+    const int dz[4] = {1, -1, 0, 0};
+    const int turns[4] = {2, 0, 3, 1};
+    for (int side = 0; side < 4; ++side)
+    {
+      if (maze.isWall(x + dx[side], z + dz[side]))
+        fn(PackedPiece::pack(PIECE_WALL, packX, packZ, turns[side]));
+    }
+  }
+}
+
+#endif
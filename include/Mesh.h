@@ -34,6 +34,12 @@ public:
   Mesh(std::vector<Vertex> vertices, std::vector<unsigned int> indices, std::vector<Texture> textures);
   void Draw(Shader &shader) const;
 
+  // raw buffers, so other vertex arrays (e.g. instanced ones) can share this geometry
+  unsigned int getVAO() const { return VAO; }
+  unsigned int getVBO() const { return VBO; }
+  unsigned int getEBO() const { return EBO; }
+  unsigned int getIndexCount() const { return static_cast<unsigned int>(indices.size()); }
+
 private:
   // render data
   unsigned int VAO, VBO, EBO;
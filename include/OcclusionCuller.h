@@ -2,71 +2,143 @@
 #define OCCLUSION_CULLER_H
 
 #include <glm/glm.hpp>
-#include <glm/gtc/matrix_transform.hpp>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <utility>
 #include <vector>
-#include <unordered_map>
-#include <unordered_set>
-
-class MazeGenerator; // Forward declaration
-
-struct OcclusionQuery
-{
-  unsigned int queryID;
-  glm::ivec2 cellPos;
-  bool resultReady;
-  bool wasVisible;
-  int framesSinceQuery;
-
-  OcclusionQuery() : queryID(0), cellPos(0), resultReady(false), wasVisible(true), framesSinceQuery(0) {}
-};
-
+#include "BitGrid.h"
+#include "FrustumCuller.h"
+
+// Exact visibility of maze cells from the camera, recomputed once per frame. Walls are
+// full-height columns, so what the camera sees is decided in 2D: update() sweeps the cells
+// around the camera outwards in rings of equal Manhattan distance, keeping the angular
+// intervals hidden by the walls met so far. A straight line from the camera visits cells in
+// strictly increasing Manhattan distance, so a ring can only be hidden by earlier rings and a
+// cell is visible exactly when its angular extent isn't entirely covered.
+//
+// Independently of the grid, occluder quads (the nearest wall faces, or any other geometry) can be
+// rasterized on the CPU into a small depth buffer, tiled across worker threads, and reduced into a
+// max-depth pyramid that boxes are tested against. That holds for any camera pitch and needs no
+// GPU readback. Rasterization is inner-conservative: a pixel is only written when it lies entirely
+// inside an occluder, with the occluder's farthest depth across it, so nothing visible is culled.
 class OcclusionCuller
 {
 public:
-  OcclusionCuller();
-  ~OcclusionCuller();
+  static constexpr int DEPTH_WIDTH = 256;
+  static constexpr int DEPTH_HEIGHT = 128;
+  static constexpr int TILE_SIZE = 32;      // square tiles, rasterized one per thread at a time
+  static constexpr int DEPTH_LEVELS = 8;    // 256x128 down to 2x1
+  static constexpr int MAX_HELPER_THREADS = 3;
 
-  // Initialize occlusion culling system
-  void initialize();
-
-  // Begin occlusion culling for this frame
-  void beginFrame();
-
-  // Check if a cell should be rendered based on occlusion
-  bool shouldRenderCell(const glm::ivec2 &cellPos, const glm::vec3 &worldPos,
-                        const glm::vec3 &cameraPos, const MazeGenerator &maze);
-
-  // End occlusion culling and process queries
-  void endFrame();
-
-  // Cleanup
-  void cleanup();
-
-  // Get statistics
-  int getQueriesActive() const { return activeQueries.size(); }
-  int getCellsOccluded() const { return occludedCells; }
+  OcclusionCuller() = default;
+  ~OcclusionCuller();
+  OcclusionCuller(const OcclusionCuller &) = delete;
+  OcclusionCuller &operator=(const OcclusionCuller &) = delete;
+
+  // Recomputes visibility from cameraPos for the cells within `radius` (on each axis) of the
+  // camera's cell. Maze is anything with isWall(x, z) (MazeGenerator, ChunkedWorld).
+  template <typename Maze>
+  void update(const Maze &maze, const glm::vec3 &cameraPos, int radius);
+
+  // False while the camera is inside a wall (nothing is hidden then) or before the first update()
+  bool isValid() const { return valid; }
+
+  // Cells seen from the camera, as a (2 * radius + 1)^2 grid starting at (getOriginX(), getOriginZ());
+  // cells outside it are never visible
+  const BitGrid &getVisibility() const { return visibility; }
+  int getOriginX() const { return originX; }
+  int getOriginZ() const { return originZ; }
+  bool isCellVisible(int x, int z) const
+  {
+    x -= originX, z -= originZ;
+    return x >= 0 && x < visibility.getWidth() && z >= 0 && z < visibility.getHeight() && visibility.test(x, z);
+  }
+
+  // Floor cells in the last window that were visible / hidden behind walls
+  int getCellsVisible() const { return cellsVisible; }
+  int getCellsOccluded() const { return cellsOccluded; }
+
+  // Occluders for the next rasterize(): planar quads with corners in order (either winding)
+  void clearOccluders() { occluders.clear(); }
+  void addOccluder(const glm::vec3 &a, const glm::vec3 &b, const glm::vec3 &c, const glm::vec3 &d);
+  // Adds the faces of walls bordering floor cells within `radius` of the camera's cell that face
+  // the camera, with runs of coplanar faces merged into one quad
+  template <typename Maze>
+  void addWallOccluders(const Maze &maze, const glm::vec3 &cameraPos, int radius);
+
+  // Rasterizes the occluders as seen through viewProjection and rebuilds the depth pyramid
+  void rasterize(const glm::mat4 &viewProjection);
+  bool hasDepth() const { return depthValid; }
+  void invalidateDepth() { depthValid = false; }
+
+  // True if the box is certainly behind the rasterized occluders. Boxes crossing the near plane or
+  // off screen are never reported occluded; that's the frustum's job.
+  bool isAABBOccluded(const AABB &box) const;
+
+  int getOccluderPolygons() const { return static_cast<int>(polygons.size()); }
+  double getRasterMs() const { return rasterMs; }
 
 private:
-  std::unordered_map<int, OcclusionQuery> queryPool;
-  std::unordered_set<int> activeQueries;
-  std::unordered_map<int, bool> visibilityCache;
-
-  int nextQueryID;
-  int frameCount;
-  int occludedCells;
-
-  // Configuration
-  static const int MAX_QUERIES = 512;
-  static const int QUERY_FREQUENCY = 3;              // Query every N frames for non-visible objects
-  static constexpr float OCCLUSION_DISTANCE = 15.0f; // Max distance for occlusion queries
-
-  // Helper functions
-  int getCellKey(const glm::ivec2 &cellPos) const;
-  bool isLikelyOccluded(const glm::vec3 &cellPos, const glm::vec3 &cameraPos,
-                        const MazeGenerator &maze) const;
-  void renderOcclusionProxy(const glm::vec3 &position);
-  void updateQueryResults();
-  void cleanupOldQueries();
+  using Interval = std::pair<float, float>; // angles in [-pi, pi]
+
+  BitGrid visibility;
+  int originX = 0, originZ = 0;
+  bool valid = false;
+  int cellsVisible = 0;
+  int cellsOccluded = 0;
+
+  // Merged, sorted intervals hidden by the rings swept so far, and those added by the current ring
+  std::vector<Interval> hidden;
+  std::vector<Interval> ringHidden;
+
+  bool isHidden(const Interval &interval) const;
+  void mergeRing();
+  bool allHidden() const;
+
+  // A quad clipped by the near plane has up to five corners
+  static constexpr int MAX_POLYGON_EDGES = 5;
+
+  // Convex screen-space polygon, set up for edge-function rasterization: a pixel is covered where
+  // every edge is >= 0 at its centre (the edges are pulled in by half a pixel, so that means the
+  // whole pixel is inside), and depth = depthA * x + depthB * y + depthC at its farthest corner.
+  // Unused edges are all zero.
+  struct RasterPolygon
+  {
+    float edgeA[MAX_POLYGON_EDGES], edgeB[MAX_POLYGON_EDGES], edgeC[MAX_POLYGON_EDGES];
+    float depthA, depthB, depthC;
+    int minX, minY, maxX, maxY;
+  };
+
+  static constexpr int TILES_X = DEPTH_WIDTH / TILE_SIZE;
+  static constexpr int TILES_Y = DEPTH_HEIGHT / TILE_SIZE;
+
+  std::vector<glm::vec3> occluders; // four corners per quad
+  std::vector<RasterPolygon> polygons;
+  std::vector<uint32_t> tileBins[TILES_X * TILES_Y];
+  // Level 0 holds the nearest occluder depth per pixel ([0, 1], 1 where there's none); each
+  // further level holds the farthest of the 2x2 texels below it
+  std::vector<float> depthLevels[DEPTH_LEVELS];
+  glm::mat4 rasterViewProjection{1.0f};
+  bool depthValid = false;
+  double rasterMs = 0.0;
+
+  // Helper threads share the tiles of each rasterize() with the calling thread
+  std::vector<std::thread> workers;
+  std::mutex mutex;
+  std::condition_variable wake;
+  std::condition_variable finished;
+  int rasterFrame = 0;
+  int workersBusy = 0;
+  bool stopping = false;
+  std::atomic<int> nextTile{0};
+
+  void addPolygon(const glm::vec4 *clip, int count);
+  void rasterizeTiles();
+  void rasterizeTile(int tile);
+  void workerLoop();
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -44,8 +44,10 @@ public:
   // Constructor
   Player(Camera *cam, glm::vec3 startPos = glm::vec3(0.0f, 0.0f, 0.0f));
 
-  // Update player physics and position
-  void Update(float deltaTime, const MazeGenerator &maze);
+  // Update player physics and position. Maze is anything with isWall(x, z): MazeGenerator or
+  // ChunkedWorld (instantiated in Player.cpp)
+  template <typename Maze>
+  void Update(float deltaTime, const Maze &maze);
 
   // Process player input
   void ProcessMovement(PlayerMovement direction, float deltaTime, bool running = false);
@@ -55,19 +57,24 @@ public:
   void ToggleGodMode();
 
   // Collision detection
-  bool CheckCollision(const glm::vec3 &newPos, const MazeGenerator &maze);
+  template <typename Maze>
+  bool CheckCollision(const glm::vec3 &newPos, const Maze &maze);
 
   // Get the position where the camera should be (at eye level)
   glm::vec3 GetCameraPosition() const;
 
   // Set player position (with collision checking)
-  void SetPosition(const glm::vec3 &newPos, const MazeGenerator &maze);
+  template <typename Maze>
+  void SetPosition(const glm::vec3 &newPos, const Maze &maze);
 
 private:
   // Internal collision helpers
-  bool CheckWallCollision(const glm::vec3 &pos, const MazeGenerator &maze);
-  bool CheckGroundCollision(const glm::vec3 &pos, const MazeGenerator &maze);
-  glm::vec3 ResolveCollision(const glm::vec3 &oldPos, const glm::vec3 &newPos, const MazeGenerator &maze);
+  template <typename Maze>
+  bool CheckWallCollision(const glm::vec3 &pos, const Maze &maze);
+  template <typename Maze>
+  bool CheckGroundCollision(const glm::vec3 &pos, const Maze &maze);
+  template <typename Maze>
+  glm::vec3 ResolveCollision(const glm::vec3 &oldPos, const glm::vec3 &newPos, const Maze &maze);
 
   // Physics helpers
   void ApplyGravity(float deltaTime);
@@ -0,0 +1,96 @@
+#ifndef POTENTIALLY_VISIBLE_SET_H
+#define POTENTIALLY_VISIBLE_SET_H
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+#include "BitGrid.h"
+
+class MazeGenerator;
+
+// Precomputed cell-to-cell visibility for a fixed maze. Walls are full height, so visibility is
+// a 2D question: a floor cell sees another if straight lines from anywhere in the first to
+// anywhere in the second cross only floor (lines that merely graze wall corners don't count).
+// That is decided exactly, so the set holds everything visible from any eye position in the
+// cell: lines are searched in line space one octant of directions at a time, following the cells
+// a line can pass through while keeping the convex set of lines that cross every cell edge on
+// the way. Each floor cell keeps the cells it sees within
+// `radius` as a bitset over the window centred on it, stored as alternating invisible/visible run
+// lengths (varint bytes); dense layouts compress well.
+//
+// build() snapshots the maze and computes the set on worker threads; the render thread keeps
+// drawing without it until isReady().
+class PotentiallyVisibleSet
+{
+public:
+  PotentiallyVisibleSet() = default;
+  ~PotentiallyVisibleSet() { cancel(); }
+  PotentiallyVisibleSet(const PotentiallyVisibleSet &) = delete;
+  PotentiallyVisibleSet &operator=(const PotentiallyVisibleSet &) = delete;
+
+  // Starts building for `maze`, abandoning any build in progress. threadCount <= 0 picks one per
+  // hardware thread, leaving one for the render loop.
+  void build(const MazeGenerator &maze, int radius, int threadCount = 0);
+  void cancel();
+
+  bool isReady() const { return ready.load(std::memory_order_acquire); }
+  bool isBuilding() const { return !workers.empty() && !isReady(); }
+  float getProgress() const;
+
+  // Cells visible from floor cell (x, z), as a (2 * radius + 1)^2 grid whose centre is (x, z);
+  // nullptr until the set is ready or if (x, z) isn't a floor cell. Decoded on first use and
+  // kept until another cell is asked for, so this is for the render thread only.
+  const BitGrid *visibleFrom(int x, int z);
+
+  int getRadius() const { return radius; }
+  size_t getMemoryUsage() const { return runs.size() + offsets.size() * sizeof(uint32_t); }
+  double getBuildMs() const { return buildMs; }
+
+private:
+  // Snapshot the workers read; true where the cell is floor
+  BitGrid floorBits;
+  int width = 0, height = 0;
+  int radius = 0;
+
+  std::vector<std::thread> workers;
+  std::atomic<bool> stopping{false};
+  std::atomic<bool> ready{false};
+  std::atomic<int> rowsDone{0};
+  std::atomic<int> workersRunning{0};
+  std::atomic<int> nextRow{0};
+
+  // While building: one encoded set per cell, each written by a single worker. Once ready:
+  // all of them back to back in `runs`, cell i starting at offsets[i] and ending at offsets[i + 1].
+  std::vector<std::vector<uint8_t>> cellRuns;
+  std::vector<uint8_t> runs;
+  std::vector<uint32_t> offsets;
+  double buildMs = 0.0;
+
+  BitGrid decoded;
+  int decodedX = 0, decodedZ = 0;
+  bool hasDecoded = false;
+
+  // A line z = slope * x + offset, in the frame of an octant: cell (u, v) of the octant is cell
+  // (x + u * xu + v * xv, z + u * zu + v * zv) of the maze, and lines run towards +u and +v
+  // with slopes in [0, 1]
+  struct Line
+  {
+    double slope, offset;
+  };
+  using LineSet = std::vector<Line>; // convex polygon of lines, corners in order
+  struct Octant
+  {
+    int xu, xv, zu, zv;
+  };
+
+  bool isOpen(int x, int z) const { return x >= 0 && x < width && z >= 0 && z < height && floorBits.test(x, z); }
+  // Marks the cells reached from (u, v) by the lines in lines[depth], which all pass through
+  // every cell between it and the octant's source cell (x, z)
+  void sweepLines(int x, int z, const Octant &octant, int u, int v, std::vector<LineSet> &lines, size_t depth,
+                  std::vector<uint64_t> &window) const;
+  void encodeCell(int x, int z, std::vector<uint64_t> &window, std::vector<LineSet> &lines, std::vector<uint8_t> &out) const;
+  void workerLoop(double startMs);
+};
+
+#endif
@@ -0,0 +1,44 @@
+#ifndef QUADTREE_CULLER_H
+#define QUADTREE_CULLER_H
+
+#include <glm/glm.hpp>
+#include <vector>
+#include "FrustumCuller.h"
+
+// Frustum culling of a cell window through an implicit quadtree aligned to the chunk grid:
+// 64-cell regions split into 32-cell blocks, 16-cell chunks, 8-cell and finally 4-cell leaves.
+// A node outside the frustum drops all of its cells with one test and a node entirely inside
+// accepts them with one test; only leaves that a frustum plane cuts through leave their cells
+// for a per-cell test. Nodes are clipped to the window, so the tree never reaches past it.
+class QuadtreeCuller
+{
+public:
+  struct Stats
+  {
+    int nodesVisited = 0; // node AABB tests
+    int nodesCulled = 0;  // nodes dropped whole
+    int nodesInside = 0;  // nodes accepted whole
+    int cellsCulled = 0;  // floor cells dropped with their node
+  };
+
+  static const int ROOT_SIZE = 64;
+  static const int LEAF_SIZE = 4;
+
+  // Sorts the floor cells of [x, x + w) x [z, z + h) into `visible` (in nodes entirely inside the
+  // frustum) and `candidates` (in leaves crossing it, still to be tested per cell); both are
+  // appended to. Maze is anything with forEachFloorCell (MazeGenerator, ChunkedWorld).
+  template <typename Maze>
+  void collect(const Maze &maze, const FrustumCuller &frustum, int x, int z, int w, int h,
+               std::vector<glm::ivec2> &visible, std::vector<glm::ivec2> &candidates);
+
+  const Stats &getStats() const { return stats; }
+
+private:
+  Stats stats;
+
+  template <typename Maze>
+  void visitNode(const Maze &maze, const FrustumCuller &frustum, int nodeX, int nodeZ, int size,
+                 const glm::ivec4 &window, std::vector<glm::ivec2> &visible, std::vector<glm::ivec2> &candidates);
+};
+
+#endif
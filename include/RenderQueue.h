@@ -0,0 +1,83 @@
+#ifndef RENDER_QUEUE_H
+#define RENDER_QUEUE_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <vector>
+
+#include <shader.h>
+#include "Mesh.h"
+
+// Per-frame draw list. Items are keyed by (program, texture, mesh, depth), radix-sorted and then
+// submitted so that each program, texture and vertex array is bound once per run of equal keys.
+class RenderQueue
+{
+public:
+  // State changes issued by the last flush()
+  struct Stats
+  {
+    int programBinds = 0;
+    int textureBinds = 0;
+    int meshBinds = 0;
+    int draws = 0;
+  };
+
+  // Start a new frame; programs, textures and meshes must be registered again
+  void clear();
+
+  // Register a program for this frame. colorUniform names the per-item vec3 it receives.
+  // Per-program constants can be set beforehand; uniform values persist in the program object.
+  int addProgram(const Shader &shader, const char *colorUniform);
+
+  // texture 0 means the item doesn't sample a texture (nothing is bound for it)
+  void submit(int program, unsigned int texture, const Mesh &mesh, const glm::mat4 &model, const glm::vec3 &color, float depth);
+
+  // Sort (if enabled) and draw everything in the queue
+  void flush();
+
+  void setSorting(bool enabled) { sorting = enabled; }
+  bool getSorting() const { return sorting; }
+
+  size_t size() const { return items.size(); }
+  const Stats &getStats() const { return stats; }
+
+  // Depth is quantized over [0, MAX_DEPTH) world units, nearest first
+  static constexpr float MAX_DEPTH = 100.0f;
+
+private:
+  struct Program
+  {
+    const Shader *shader;
+    UniformHandle model;
+    UniformHandle color;
+  };
+
+  struct Item
+  {
+    const Mesh *mesh;
+    unsigned int texture;
+    int program;
+    glm::mat4 model;
+    glm::vec3 color;
+  };
+
+  std::vector<Program> programs;
+  std::vector<unsigned int> textures;
+  std::vector<const Mesh *> meshes;
+
+  std::vector<Item> items;
+  std::vector<uint64_t> keys;   // sort key; low 16 bits hold nothing, the item index rides in the payload
+  std::vector<uint32_t> order;  // item indices in submission order, then sorted order
+  std::vector<uint64_t> keysScratch;
+  std::vector<uint32_t> orderScratch;
+
+  bool sorting = true;
+  Stats stats;
+
+  int textureSlot(unsigned int texture);
+  int meshSlot(const Mesh *mesh);
+  void radixSort();
+};
+
+#endif
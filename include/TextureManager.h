@@ -4,6 +4,7 @@
 #include <glad/glad.h>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 class TextureManager
 {
@@ -16,6 +17,9 @@ public:
 
   unsigned int loadTexture(const std::string &path);
   unsigned int getTexture(const std::string &path);
+  // Loads the images into the layers of one GL_TEXTURE_2D_ARRAY with mipmaps generated per layer.
+  // Layers take the size of the first image; others are resampled to match.
+  unsigned int loadTextureArray(const std::vector<std::string> &paths);
   void cleanup();
 
 private:
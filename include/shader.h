@@ -8,6 +8,19 @@
 #include <fstream>
 #include <sstream>
 #include <iostream>
+#include <unordered_map>
+#include <vector>
+#include <cstring>
+
+// Pre-resolved uniform location. Obtain once with Shader::uniform() and keep it around;
+// setting through a handle is an array index instead of a driver string lookup.
+struct UniformHandle
+{
+  GLint location = -1;
+  int slot = -1; // index into the owning Shader's value cache
+
+  bool isValid() const { return location >= 0; }
+};
 
 class Shader
 {
@@ -68,6 +81,39 @@ public:
     // delete the shaders as they're linked into our program now and no longer necessary
     glDeleteShader(vertex);
     glDeleteShader(fragment);
+    // 3. build the uniform location table
+    reflectUniforms();
+  }
+  // compute-only program (GL 4.3+); check ID != 0 before dispatching
+  // ------------------------------------------------------------------------
+  explicit Shader(const char *computePath)
+  {
+    std::string computeCode;
+    std::ifstream cShaderFile;
+    cShaderFile.exceptions(std::ifstream::failbit | std::ifstream::badbit);
+    try
+    {
+      cShaderFile.open(computePath);
+      std::stringstream cShaderStream;
+      cShaderStream << cShaderFile.rdbuf();
+      cShaderFile.close();
+      computeCode = cShaderStream.str();
+    }
+    catch (std::ifstream::failure &e)
+    {
+      std::cout << "ERROR::SHADER::FILE_NOT_SUCCESSFULLY_READ: " << e.what() << std::endl;
+    }
+    const char *cShaderCode = computeCode.c_str();
+    unsigned int compute = glCreateShader(GL_COMPUTE_SHADER);
+    glShaderSource(compute, 1, &cShaderCode, NULL);
+    glCompileShader(compute);
+    checkCompileErrors(compute, "COMPUTE");
+    ID = glCreateProgram();
+    glAttachShader(ID, compute);
+    glLinkProgram(ID);
+    checkCompileErrors(ID, "PROGRAM");
+    glDeleteShader(compute);
+    reflectUniforms();
   }
   // activate the shader
   // ------------------------------------------------------------------------
@@ -75,66 +121,186 @@ public:
   {
     glUseProgram(ID);
   }
+  // look up a uniform in the table built at link time; invalid handle if the program has no such active uniform
+  // ------------------------------------------------------------------------
+  UniformHandle uniform(const std::string &name) const
+  {
+    auto it = uniformSlots.find(name);
+    if (it == uniformSlots.end())
+      return UniformHandle();
+    UniformHandle handle;
+    handle.location = slots[it->second].location;
+    handle.slot = it->second;
+    return handle;
+  }
   // utility uniform functions
+  // the program must be in use; values equal to the last upload through this Shader are skipped
   // ------------------------------------------------------------------------
+  void setBool(UniformHandle handle, bool value) const
+  {
+    setInt(handle, (int)value);
+  }
   void setBool(const std::string &name, bool value) const
   {
-    glUniform1i(glGetUniformLocation(ID, name.c_str()), (int)value);
+    setBool(uniform(name), value);
   }
   // ------------------------------------------------------------------------
+  void setInt(UniformHandle handle, int value) const
+  {
+    if (changed(handle, &value, sizeof(value)))
+      glUniform1i(handle.location, value);
+  }
   void setInt(const std::string &name, int value) const
   {
-    glUniform1i(glGetUniformLocation(ID, name.c_str()), value);
+    setInt(uniform(name), value);
   }
   // ------------------------------------------------------------------------
+  void setFloat(UniformHandle handle, float value) const
+  {
+    if (changed(handle, &value, sizeof(value)))
+      glUniform1f(handle.location, value);
+  }
   void setFloat(const std::string &name, float value) const
   {
-    glUniform1f(glGetUniformLocation(ID, name.c_str()), value);
+    setFloat(uniform(name), value);
   }
   // ------------------------------------------------------------------------
+  void setVec2(UniformHandle handle, const glm::vec2 &value) const
+  {
+    if (changed(handle, &value[0], sizeof(float) * 2))
+      glUniform2fv(handle.location, 1, &value[0]);
+  }
   void setVec2(const std::string &name, const glm::vec2 &value) const
   {
-    glUniform2fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]);
+    setVec2(uniform(name), value);
   }
   void setVec2(const std::string &name, float x, float y) const
   {
-    glUniform2f(glGetUniformLocation(ID, name.c_str()), x, y);
+    setVec2(uniform(name), glm::vec2(x, y));
   }
   // ------------------------------------------------------------------------
+  void setVec3(UniformHandle handle, const glm::vec3 &value) const
+  {
+    if (changed(handle, &value[0], sizeof(float) * 3))
+      glUniform3fv(handle.location, 1, &value[0]);
+  }
   void setVec3(const std::string &name, const glm::vec3 &value) const
   {
-    glUniform3fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]);
+    setVec3(uniform(name), value);
   }
   void setVec3(const std::string &name, float x, float y, float z) const
   {
-    glUniform3f(glGetUniformLocation(ID, name.c_str()), x, y, z);
+    setVec3(uniform(name), glm::vec3(x, y, z));
   }
   // ------------------------------------------------------------------------
+  void setVec4(UniformHandle handle, const glm::vec4 &value) const
+  {
+    if (changed(handle, &value[0], sizeof(float) * 4))
+      glUniform4fv(handle.location, 1, &value[0]);
+  }
   void setVec4(const std::string &name, const glm::vec4 &value) const
   {
-    glUniform4fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]);
+    setVec4(uniform(name), value);
   }
   void setVec4(const std::string &name, float x, float y, float z, float w) const
   {
-    glUniform4f(glGetUniformLocation(ID, name.c_str()), x, y, z, w);
+    setVec4(uniform(name), glm::vec4(x, y, z, w));
   }
   // ------------------------------------------------------------------------
+  void setMat2(UniformHandle handle, const glm::mat2 &mat) const
+  {
+    if (changed(handle, &mat[0][0], sizeof(float) * 4))
+      glUniformMatrix2fv(handle.location, 1, GL_FALSE, &mat[0][0]);
+  }
   void setMat2(const std::string &name, const glm::mat2 &mat) const
   {
-    glUniformMatrix2fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+    setMat2(uniform(name), mat);
   }
   // ------------------------------------------------------------------------
+  void setMat3(UniformHandle handle, const glm::mat3 &mat) const
+  {
+    if (changed(handle, &mat[0][0], sizeof(float) * 9))
+      glUniformMatrix3fv(handle.location, 1, GL_FALSE, &mat[0][0]);
+  }
   void setMat3(const std::string &name, const glm::mat3 &mat) const
   {
-    glUniformMatrix3fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+    setMat3(uniform(name), mat);
   }
   // ------------------------------------------------------------------------
+  void setMat4(UniformHandle handle, const glm::mat4 &mat) const
+  {
+    if (changed(handle, &mat[0][0], sizeof(float) * 16))
+      glUniformMatrix4fv(handle.location, 1, GL_FALSE, &mat[0][0]);
+  }
   void setMat4(const std::string &name, const glm::mat4 &mat) const
   {
-    glUniformMatrix4fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+    setMat4(uniform(name), mat);
   }
 
 private:
+  // last value uploaded to each active uniform (array elements get a slot each)
+  struct UniformSlot
+  {
+    GLint location = -1;
+    bool hasValue = false;
+    unsigned char value[sizeof(float) * 16];
+  };
+  std::unordered_map<std::string, int> uniformSlots;
+  mutable std::vector<UniformSlot> slots;
+
+  // query every active uniform once after linking
+  // ------------------------------------------------------------------------
+  void reflectUniforms()
+  {
+    GLint count = 0, maxLength = 0;
+    glGetProgramiv(ID, GL_ACTIVE_UNIFORMS, &count);
+    glGetProgramiv(ID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+    std::vector<GLchar> nameBuffer(maxLength > 0 ? maxLength : 1);
+
+    for (GLint i = 0; i < count; ++i)
+    {
+      GLint size = 0;
+      GLenum type = 0;
+      GLsizei length = 0;
+      glGetActiveUniform(ID, (GLuint)i, (GLsizei)nameBuffer.size(), &length, &size, &type, nameBuffer.data());
+      std::string name(nameBuffer.data(), length);
+
+      // arrays are reported as "name[0]"; register "name" and every element
+      std::string baseName = name;
+      bool isArray = name.size() > 3 && name.compare(name.size() - 3, 3, "[0]") == 0;
+      if (isArray)
+        baseName = name.substr(0, name.size() - 3);
+
+      for (GLint element = 0; element < size; ++element)
+      {
+        std::string elementName = isArray ? baseName + "[" + std::to_string(element) + "]" : name;
+        GLint location = glGetUniformLocation(ID, elementName.c_str());
+        if (location < 0)
+          continue; // members of uniform blocks have no location
+
+        UniformSlot slot;
+        slot.location = location;
+        uniformSlots[elementName] = (int)slots.size();
+        if (isArray && element == 0)
+          uniformSlots[baseName] = (int)slots.size();
+        slots.push_back(slot);
+      }
+    }
+  }
+  // records value as the uniform's current contents; false if it was already uploaded
+  // ------------------------------------------------------------------------
+  bool changed(UniformHandle handle, const void *value, size_t bytes) const
+  {
+    if (!handle.isValid())
+      return false;
+    UniformSlot &slot = slots[handle.slot];
+    if (slot.hasValue && std::memcmp(slot.value, value, bytes) == 0)
+      return false;
+    std::memcpy(slot.value, value, bytes);
+    slot.hasValue = true;
+    return true;
+  }
+
   // utility function for checking shader compilation/linking errors.
   // ------------------------------------------------------------------------
   void checkCompileErrors(GLuint shader, std::string type)
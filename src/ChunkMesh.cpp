@@ -0,0 +1,305 @@
+#include "ChunkMesh.h"
+#include "MazeGenerator.h"
+#include <algorithm>
+
+namespace
+{
+  // Greedy rectangle cover of a w x h mask (row-major). Each set cell ends up in exactly one
+  // rectangle; growth along X and/or Z can be disabled to get 1D runs. Clears the mask.
+  template <typename Fn>
+  void greedyRects(std::vector<char> &mask, int w, int h, bool mergeX, bool mergeZ, Fn &&emit)
+  {
+    for (int z = 0; z < h; ++z)
+    {
+      for (int x = 0; x < w; ++x)
+      {
+        if (!mask[z * w + x])
+          continue;
+
+        int rw = 1;
+        while (mergeX && x + rw < w && mask[z * w + x + rw])
+          ++rw;
+
+        int rh = 1;
+        while (mergeZ && z + rh < h)
+        {
+          bool fullRow = true;
+          for (int i = 0; i < rw && fullRow; ++i)
+            fullRow = mask[(z + rh) * w + x + i] != 0;
+          if (!fullRow)
+            break;
+          ++rh;
+        }
+
+        for (int j = 0; j < rh; ++j)
+          std::fill(mask.begin() + (z + j) * w + x, mask.begin() + (z + j) * w + x + rw, 0);
+
+        emit(x, z, rw, rh);
+      }
+    }
+  }
+}
+
+bool ChunkMesh::Draw(MazePiece piece) const
+{
+  if (indexCount[piece] == 0)
+    return false;
+
+  glBindVertexArray(VAO);
+  glDrawElementsBaseVertex(GL_TRIANGLES, indexCount[piece], GL_UNSIGNED_INT,
+                           (void *)((firstIndex + indexOffset[piece]) * sizeof(unsigned int)), baseVertex);
+  return true;
+}
+
+bool ChunkMesh::DrawAll() const
+{
+  unsigned int total = totalIndexCount();
+  if (total == 0)
+    return false;
+
+  glBindVertexArray(VAO);
+  glDrawElementsBaseVertex(GL_TRIANGLES, total, GL_UNSIGNED_INT, (void *)(firstIndex * sizeof(unsigned int)), baseVertex);
+  return true;
+}
+
+void ChunkMeshBuilder::rebuild(const MazeGenerator &maze, const Mesh &wallMesh, const Mesh &floorMesh, const Mesh &ceilingMesh)
+{
+  release();
+
+  std::array<const Mesh *, PIECE_COUNT> templates{};
+  templates[PIECE_FLOOR] = &floorMesh;
+  templates[PIECE_CEILING] = &ceilingMesh;
+  templates[PIECE_LIGHT_TILE] = &ceilingMesh;
+  templates[PIECE_WALL] = &wallMesh;
+
+  const int chunksX = (maze.getWidth() + MazeGenerator::CHUNK_SIZE - 1) / MazeGenerator::CHUNK_SIZE;
+  const int chunksZ = (maze.getHeight() + MazeGenerator::CHUNK_SIZE - 1) / MazeGenerator::CHUNK_SIZE;
+  chunks.resize(chunksX * chunksZ);
+
+  for (int cz = 0; cz < chunksZ; ++cz)
+  {
+    for (int cx = 0; cx < chunksX; ++cx)
+    {
+      ChunkMesh &chunk = chunks[cz * chunksX + cx];
+      chunk.chunkX = cx;
+      chunk.chunkZ = cz;
+      buildChunk(chunk, maze, templates);
+    }
+  }
+
+  upload();
+}
+
+void ChunkMeshBuilder::release()
+{
+  if (VAO != 0)
+  {
+    glDeleteVertexArrays(1, &VAO);
+    glDeleteBuffers(1, &VBO);
+    glDeleteBuffers(1, &EBO);
+    VAO = VBO = EBO = 0;
+  }
+  chunks.clear();
+  vertexCount = 0;
+  triangleCount = 0;
+}
+
+void ChunkMeshBuilder::buildChunk(ChunkMesh &chunk, const MazeGenerator &maze, const std::array<const Mesh *, PIECE_COUNT> &templates)
+{
+  using namespace MazeGeometry;
+
+  std::array<std::vector<ChunkVertex>, PIECE_COUNT> vertices;
+  std::array<std::vector<unsigned int>, PIECE_COUNT> indices;
+
+  // Only the vertices referenced by the template's indices are baked (plane primitives carry an unused back face)
+  std::array<unsigned int, PIECE_COUNT> usedVertices{};
+  for (int piece = 0; piece < PIECE_COUNT; ++piece)
+  {
+    const auto &templateIndices = templates[piece]->indices;
+    usedVertices[piece] = templateIndices.empty() ? 0 : *std::max_element(templateIndices.begin(), templateIndices.end()) + 1;
+  }
+
+  const MazeGridView cells = maze.chunkView(chunk.chunkX, chunk.chunkZ);
+  const int startX = cells.getOriginX();
+  const int startZ = cells.getOriginZ();
+  const int endX = startX + cells.getWidth();
+  const int endZ = startZ + cells.getHeight();
+
+  chunk.bounds = AABB(cellBounds(startX, startZ).min, cellBounds(endX - 1, endZ - 1).max);
+
+  // Bakes the template quad of `packed`, optionally stretched over a run of identical pieces:
+  // localSpan scales the quad in its own space, worldOffset moves it to the run's centre and
+  // uvSpan repeats the texture once per original piece (textures use GL_REPEAT)
+  auto appendQuad = [&](const PackedPiece &packed, const glm::vec3 &worldOffset, const glm::vec3 &localSpan, const glm::vec2 &uvSpan)
+  {
+    MazePiece piece = packed.piece();
+    glm::mat4 model = glm::translate(glm::mat4(1.0f), worldOffset) * modelMatrix(packed) * glm::scale(glm::mat4(1.0f), localSpan);
+    const Mesh &mesh = *templates[piece];
+    glm::mat3 normalMatrix = glm::mat3(glm::transpose(glm::inverse(model)));
+    unsigned int base = static_cast<unsigned int>(vertices[piece].size());
+
+    for (unsigned int i = 0; i < usedVertices[piece]; ++i)
+    {
+      const Vertex &v = mesh.vertices[i];
+      ChunkVertex baked;
+      baked.Position = glm::vec3(model * glm::vec4(v.Position, 1.0f));
+      baked.Normal = glm::normalize(normalMatrix * v.Normal);
+      baked.TexCoords = v.TexCoords * uvSpan;
+      baked.Material = piece;
+      vertices[piece].push_back(baked);
+    }
+    for (unsigned int index : mesh.indices)
+      indices[piece].push_back(base + index);
+  };
+
+  auto appendPiece = [&](const PackedPiece &packed)
+  {
+    appendQuad(packed, glm::vec3(0.0f), glm::vec3(1.0f), glm::vec2(1.0f));
+  };
+
+  if (!greedyMerging)
+  {
+    for (glm::ivec2 cell : cells.floorCells())
+      forEachCellPiece(maze, cell.x, cell.y, appendPiece);
+  }
+  else
+  {
+    buildMergedChunk(maze, startX, startZ, endX - startX, endZ - startZ, appendQuad, appendPiece);
+  }
+
+  append(chunk, vertices, indices);
+}
+
+template <typename QuadFn, typename PieceFn>
+void ChunkMeshBuilder::buildMergedChunk(const MazeGenerator &maze, int startX, int startZ, int w, int h, QuadFn &&appendQuad, PieceFn &&appendPiece)
+{
+  using namespace MazeGeometry;
+  std::vector<char> mask;
+
+  // Floors: rectangles of floor cells
+  mask.assign(w * h, 0);
+  for (int z = 0; z < h; ++z)
+    for (int x = 0; x < w; ++x)
+      mask[z * w + x] = !maze.isWall(startX + x, startZ + z);
+
+  auto emitFloor = [&](int x, int z, int rw, int rh)
+  {
+    appendQuad(PackedPiece::pack(PIECE_FLOOR, startX + x, startZ + z),
+               glm::vec3((rw - 1) * 0.5f * CELL_SIZE, 0.0f, (rh - 1) * 0.5f * CELL_SIZE),
+               glm::vec3(rw, 1.0f, rh), glm::vec2(rw, rh));
+  };
+  greedyRects(mask, w, h, true, true, emitFloor);
+
+  // Ceilings: rectangles on the 2x2-per-cell tile grid; light tiles break runs and stay single
+  const int tw = w * 2, th = h * 2;
+  mask.assign(tw * th, 0);
+  for (int tz = 0; tz < th; ++tz)
+  {
+    for (int tx = 0; tx < tw; ++tx)
+    {
+      int x = startX + tx / 2, z = startZ + tz / 2;
+      if (maze.isWall(x, z))
+        continue;
+      if (isLightTile(x * 2 + tx % 2, z * 2 + tz % 2))
+        appendPiece(PackedPiece::pack(PIECE_LIGHT_TILE, x, z, 0, tx % 2, tz % 2));
+      else
+        mask[tz * tw + tx] = 1;
+    }
+  }
+
+  auto emitCeiling = [&](int tx, int tz, int rw, int rh)
+  {
+    appendQuad(PackedPiece::pack(PIECE_CEILING, startX + tx / 2, startZ + tz / 2, 0, tx % 2, tz % 2),
+               glm::vec3((rw - 1) * 0.5f * CEILING_TILE_SIZE, 0.0f, (rh - 1) * 0.5f * CEILING_TILE_SIZE),
+               glm::vec3(rw, 1.0f, rh), glm::vec2(rw, rh));
+  };
+  greedyRects(mask, tw, th, true, true, emitCeiling);
+
+  // Walls: 1D runs along each of the four facing directions (same order as forEachCellPiece)
+  const int dx[4] = {0, 0, 1, -1};
+  const int dz[4] = {1, -1, 0, 0};
+  const int turns[4] = {2, 0, 3, 1};
+  for (int side = 0; side < 4; ++side)
+  {
+    mask.assign(w * h, 0);
+    for (int z = 0; z < h; ++z)
+    {
+      for (int x = 0; x < w; ++x)
+      {
+        int cellX = startX + x, cellZ = startZ + z;
+        mask[z * w + x] = !maze.isWall(cellX, cellZ) && maze.isWall(cellX + dx[side], cellZ + dz[side]);
+      }
+    }
+
+    bool alongX = dz[side] != 0;
+    auto emitWall = [&](int x, int z, int rw, int rh)
+    {
+      int length = alongX ? rw : rh;
+      appendQuad(PackedPiece::pack(PIECE_WALL, startX + x, startZ + z, turns[side]),
+                 glm::vec3((rw - 1) * 0.5f * CELL_SIZE, 0.0f, (rh - 1) * 0.5f * CELL_SIZE),
+                 glm::vec3(length, 1.0f, 1.0f), glm::vec2(length, 1.0f));
+    };
+    greedyRects(mask, w, h, alongX, !alongX, emitWall);
+  }
+}
+
+void ChunkMeshBuilder::append(ChunkMesh &chunk, const std::array<std::vector<ChunkVertex>, PIECE_COUNT> &vertices,
+                              const std::array<std::vector<unsigned int>, PIECE_COUNT> &indices)
+{
+  // Concatenate materials in MazePiece order; each keeps a contiguous index range
+  chunk.firstIndex = static_cast<unsigned int>(allIndices.size());
+  chunk.baseVertex = static_cast<int>(allVertices.size());
+
+  unsigned int chunkVertices = 0;
+  for (int piece = 0; piece < PIECE_COUNT; ++piece)
+  {
+    chunk.indexOffset[piece] = static_cast<unsigned int>(allIndices.size()) - chunk.firstIndex;
+    chunk.indexCount[piece] = static_cast<unsigned int>(indices[piece].size());
+
+    allVertices.insert(allVertices.end(), vertices[piece].begin(), vertices[piece].end());
+    for (unsigned int index : indices[piece])
+      allIndices.push_back(chunkVertices + index);
+    chunkVertices += static_cast<unsigned int>(vertices[piece].size());
+  }
+}
+
+void ChunkMeshBuilder::upload()
+{
+  vertexCount = allVertices.size();
+  triangleCount = allIndices.size() / 3;
+
+  if (!allIndices.empty())
+  {
+    glGenVertexArrays(1, &VAO);
+    glGenBuffers(1, &VBO);
+    glGenBuffers(1, &EBO);
+
+    glBindVertexArray(VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBufferData(GL_ARRAY_BUFFER, allVertices.size() * sizeof(ChunkVertex), allVertices.data(), GL_STATIC_DRAW);
+
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, allIndices.size() * sizeof(unsigned int), allIndices.data(), GL_STATIC_DRAW);
+
+    // Same attribute layout as Mesh so the existing shaders apply unchanged
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(ChunkVertex), (void *)0);
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(ChunkVertex), (void *)offsetof(ChunkVertex, Normal));
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(ChunkVertex), (void *)offsetof(ChunkVertex, TexCoords));
+    // Material index, read only by the texture-array shader
+    glEnableVertexAttribArray(ChunkMesh::MATERIAL_ATTRIB_LOCATION);
+    glVertexAttribIPointer(ChunkMesh::MATERIAL_ATTRIB_LOCATION, 1, GL_UNSIGNED_INT, sizeof(ChunkVertex), (void *)offsetof(ChunkVertex, Material));
+
+    glBindVertexArray(0);
+  }
+
+  for (auto &chunk : chunks)
+    chunk.VAO = VAO;
+
+  allVertices.clear();
+  allVertices.shrink_to_fit();
+  allIndices.clear();
+  allIndices.shrink_to_fit();
+}
@@ -0,0 +1,218 @@
+#include "ChunkStreamer.h"
+#include "MazeGeometry.h"
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+void ChunkStreamer::start(int threadCount)
+{
+  if (isRunning())
+    return;
+
+  if (threadCount <= 0)
+    threadCount = std::max(1, static_cast<int>(std::thread::hardware_concurrency()) - 1);
+
+  stopping = false;
+  for (int i = 0; i < threadCount; ++i)
+    workers.emplace_back(&ChunkStreamer::workerLoop, this);
+}
+
+void ChunkStreamer::stop()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  wake.notify_all();
+  for (std::thread &worker : workers)
+    worker.join();
+  workers.clear();
+
+  queue.clear();
+  inFlight.clear();
+  completed.clear();
+  requestedAt.clear();
+}
+
+void ChunkStreamer::workerLoop()
+{
+  std::unique_lock<std::mutex> lock(mutex);
+  while (true)
+  {
+    wake.wait(lock, [this]
+              { return stopping || !queue.empty(); });
+    if (stopping)
+      return;
+
+    Request request = queue.back();
+    queue.pop_back();
+    inFlight.insert(request.key);
+    unsigned int requestSeed = seed;
+    lock.unlock();
+
+    // Generation touches nothing shared, so it runs outside the lock
+    auto begin = Clock::now();
+    WorldChunk chunk = ChunkedWorld::generateChunk(requestSeed, ChunkedWorld::keyChunkX(request.key),
+                                                   ChunkedWorld::keyChunkZ(request.key));
+    double generateMs = std::chrono::duration<double, std::milli>(Clock::now() - begin).count();
+
+    lock.lock();
+    inFlight.erase(request.key);
+    completed.push_back({request.key, requestSeed, std::move(chunk), generateMs});
+  }
+}
+
+void ChunkStreamer::update(ChunkedWorld &world, const glm::vec3 &position, const glm::vec3 &front, const glm::vec3 &velocity)
+{
+  using namespace MazeGeometry;
+  const float CHUNK_WORLD_SIZE = ChunkedWorld::CHUNK_SIZE * CELL_SIZE;
+  const float BIAS_WEIGHT = 0.75f; // chunk widths a fully aligned chunk is pulled forward by
+  auto now = Clock::now();
+  ++frame;
+
+  // A new world (or a new seed) invalidates everything resident and in flight
+  std::vector<Result> results;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (seed != world.getSeed())
+    {
+      seed = world.getSeed();
+      queue.clear();
+      lastUsedFrame.clear();
+      requestedAt.clear();
+    }
+    results.swap(completed);
+  }
+
+  for (Result &result : results)
+  {
+    if (result.seed != seed)
+      continue;
+
+    int chunkX = ChunkedWorld::keyChunkX(result.key);
+    int chunkZ = ChunkedWorld::keyChunkZ(result.key);
+    if (!world.findChunk(chunkX, chunkZ))
+    {
+      world.insertChunk(chunkX, chunkZ, std::move(result.chunk));
+      lastUsedFrame[result.key] = frame;
+    }
+
+    stats.completedTotal++;
+    stats.generateMs += (result.generateMs - stats.generateMs) * 0.1;
+    stats.generateMaxMs = std::max(stats.generateMaxMs, result.generateMs);
+    auto requested = requestedAt.find(result.key);
+    if (requested != requestedAt.end())
+    {
+      double latencyMs = std::chrono::duration<double, std::milli>(now - requested->second).count();
+      stats.latencyMs += (latencyMs - stats.latencyMs) * 0.1;
+      stats.latencyMaxMs = std::max(stats.latencyMaxMs, latencyMs);
+      requestedAt.erase(requested);
+    }
+  }
+
+  // Position in continuous chunk units (cell x spans world x * CELL_SIZE +/- half a cell)
+  glm::vec2 here((position.x + CELL_SIZE * 0.5f) / CHUNK_WORLD_SIZE, (position.z + CELL_SIZE * 0.5f) / CHUNK_WORLD_SIZE);
+  glm::vec2 look(front.x, front.z);
+  if (glm::length(look) > 0.0f)
+    look = glm::normalize(look);
+  glm::vec2 motion(velocity.x, velocity.z);
+  glm::vec2 heading = glm::length(motion) > 0.1f ? glm::normalize(motion) : glm::vec2(0.0f);
+
+  // Wanted: a square around the camera, plus a smaller one around where the camera looks and
+  // will be in a second
+  glm::vec2 ahead = here + look * static_cast<float>(prefetchDistance) + motion / CHUNK_WORLD_SIZE;
+  int centerX = static_cast<int>(std::floor(here.x)), centerZ = static_cast<int>(std::floor(here.y));
+  int aheadX = static_cast<int>(std::floor(ahead.x)), aheadZ = static_cast<int>(std::floor(ahead.y));
+  int aheadRadius = std::max(radius - 1, 1);
+
+  std::vector<Request> wanted;
+  std::unordered_set<uint64_t> seen;
+  auto want = [&](int chunkX, int chunkZ)
+  {
+    uint64_t key = ChunkedWorld::chunkKey(chunkX, chunkZ);
+    if (!seen.insert(key).second)
+      return;
+    if (world.findChunk(chunkX, chunkZ))
+    {
+      lastUsedFrame[key] = frame;
+      return;
+    }
+
+    // Nearest first, pulled forward when in front of the camera or along the direction of travel;
+    // the chunks touching the camera's own always come first
+    glm::vec2 offset = glm::vec2(chunkX + 0.5f, chunkZ + 0.5f) - here;
+    float distance = glm::length(offset);
+    glm::vec2 direction = distance > 0.0f ? offset / distance : glm::vec2(0.0f);
+    float priority = distance - BIAS_WEIGHT * glm::dot(direction, look) - BIAS_WEIGHT * glm::dot(direction, heading);
+    if (std::abs(chunkX - centerX) <= 1 && std::abs(chunkZ - centerZ) <= 1)
+      priority -= 1000.0f;
+    wanted.push_back({key, priority});
+  };
+  for (int z = centerZ - radius; z <= centerZ + radius; ++z)
+    for (int x = centerX - radius; x <= centerX + radius; ++x)
+      want(x, z);
+  for (int z = aheadZ - aheadRadius; z <= aheadZ + aheadRadius; ++z)
+    for (int x = aheadX - aheadRadius; x <= aheadX + aheadRadius; ++x)
+      want(x, z);
+
+  // Most urgent at the back, where workers pop from
+  std::sort(wanted.begin(), wanted.end(), [](const Request &a, const Request &b)
+            { return a.priority > b.priority; });
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    queue.clear();
+    for (const Request &request : wanted)
+    {
+      if (!inFlight.count(request.key))
+        queue.push_back(request);
+    }
+
+    // Latency is measured from the first frame a chunk was wanted; forget chunks no longer wanted
+    std::unordered_map<uint64_t, Clock::time_point> stillRequested;
+    for (const Request &request : wanted)
+    {
+      auto requested = requestedAt.find(request.key);
+      stillRequested[request.key] = requested != requestedAt.end() ? requested->second : now;
+    }
+    for (uint64_t key : inFlight)
+    {
+      auto requested = requestedAt.find(key);
+      if (requested != requestedAt.end())
+        stillRequested.insert(*requested);
+    }
+    requestedAt.swap(stillRequested);
+
+    stats.queued = static_cast<int>(queue.size());
+    stats.inFlight = static_cast<int>(inFlight.size());
+  }
+  if (!wanted.empty())
+    wake.notify_all();
+
+  evict(world);
+}
+
+void ChunkStreamer::evict(ChunkedWorld &world)
+{
+  if (world.getMemoryUsage() <= memoryBudget)
+    return;
+
+  // Least recently wanted first; chunks wanted this frame are never evicted, so a budget smaller
+  // than the wanted area overshoots instead of thrashing
+  std::vector<std::pair<uint64_t, uint64_t>> candidates;
+  for (const auto &entry : lastUsedFrame)
+  {
+    if (entry.second < frame)
+      candidates.push_back({entry.second, entry.first});
+  }
+  std::sort(candidates.begin(), candidates.end());
+
+  for (const auto &candidate : candidates)
+  {
+    if (world.getMemoryUsage() <= memoryBudget)
+      break;
+    world.removeChunk(ChunkedWorld::keyChunkX(candidate.second), ChunkedWorld::keyChunkZ(candidate.second));
+    lastUsedFrame.erase(candidate.second);
+    stats.evictedTotal++;
+  }
+}
@@ -0,0 +1,97 @@
+#include "ChunkedWorld.h"
+#include <cstdlib>
+#include <utility>
+
+ChunkedWorld::ChunkedWorld(unsigned int seed)
+    : seed(seed == 0 ? std::random_device{}() : seed)
+{
+}
+
+WorldChunk ChunkedWorld::generateChunk(unsigned int seed, int chunkX, int chunkZ)
+{
+  // A one-chunk generator holds the chunk in slot (0, 0); only the bitplanes are kept
+  MazeGenerator generator(CHUNK_SIZE, CHUNK_SIZE, seed);
+  generator.generateChunk(chunkX, chunkZ, 0, 0);
+
+  WorldChunk chunk;
+  generator.releaseCells(chunk.typeBits[0], chunk.typeBits[1], chunk.visitedBits);
+  return chunk;
+}
+
+void ChunkedWorld::update(int cellX, int cellZ, int radius, int keepRadius)
+{
+  int centerX = chunkCoord(cellX);
+  int centerZ = chunkCoord(cellZ);
+
+  for (auto it = chunks.begin(); it != chunks.end();)
+  {
+    int chunkX = keyChunkX(it->first);
+    int chunkZ = keyChunkZ(it->first);
+    if (std::abs(chunkX - centerX) > keepRadius || std::abs(chunkZ - centerZ) > keepRadius)
+    {
+      memoryUsage -= it->second.memoryBytes();
+      it = chunks.erase(it);
+    }
+    else
+    {
+      ++it;
+    }
+  }
+
+  for (int cz = centerZ - radius; cz <= centerZ + radius; ++cz)
+    for (int cx = centerX - radius; cx <= centerX + radius; ++cx)
+      requireChunk(cx, cz);
+}
+
+const WorldChunk *ChunkedWorld::findChunk(int chunkX, int chunkZ) const
+{
+  auto it = chunks.find(chunkKey(chunkX, chunkZ));
+  return it != chunks.end() ? &it->second : nullptr;
+}
+
+const WorldChunk &ChunkedWorld::requireChunk(int chunkX, int chunkZ)
+{
+  auto it = chunks.find(chunkKey(chunkX, chunkZ));
+  if (it == chunks.end())
+  {
+    it = chunks.emplace(chunkKey(chunkX, chunkZ), generateChunk(seed, chunkX, chunkZ)).first;
+    memoryUsage += it->second.memoryBytes();
+  }
+  return it->second;
+}
+
+void ChunkedWorld::insertChunk(int chunkX, int chunkZ, WorldChunk &&chunk)
+{
+  WorldChunk &slot = chunks[chunkKey(chunkX, chunkZ)];
+  memoryUsage += chunk.memoryBytes() - slot.memoryBytes();
+  slot = std::move(chunk);
+}
+
+void ChunkedWorld::removeChunk(int chunkX, int chunkZ)
+{
+  auto it = chunks.find(chunkKey(chunkX, chunkZ));
+  if (it == chunks.end())
+    return;
+  memoryUsage -= it->second.memoryBytes();
+  chunks.erase(it);
+}
+
+CellType ChunkedWorld::getCellType(int x, int z) const
+{
+  const WorldChunk *chunk = findChunk(chunkCoord(x), chunkCoord(z));
+  if (!chunk)
+    return CellType::WALL;
+  return chunk->view().getCellType(localCoord(x), localCoord(z));
+}
+
+bool ChunkedWorld::isWall(int x, int z) const
+{
+  const WorldChunk *chunk = findChunk(chunkCoord(x), chunkCoord(z));
+  return !chunk || chunk->view().isWall(localCoord(x), localCoord(z));
+}
+
+bool ChunkedWorld::isFloor(int x, int z) const
+{
+  const WorldChunk *chunk = findChunk(chunkCoord(x), chunkCoord(z));
+  return chunk && chunk->view().isFloor(localCoord(x), localCoord(z));
+}
@@ -0,0 +1,34 @@
+#include "FrameUniforms.h"
+
+void FrameUniformBuffer::init()
+{
+  release();
+
+  glGenBuffers(1, &UBO);
+  glBindBuffer(GL_UNIFORM_BUFFER, UBO);
+  glBufferData(GL_UNIFORM_BUFFER, sizeof(FrameUniformData), nullptr, GL_DYNAMIC_DRAW);
+  glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+  glBindBufferBase(GL_UNIFORM_BUFFER, BINDING_POINT, UBO);
+}
+
+void FrameUniformBuffer::release()
+{
+  if (UBO != 0)
+    glDeleteBuffers(1, &UBO);
+  UBO = 0;
+}
+
+void FrameUniformBuffer::attach(const Shader &shader) const
+{
+  unsigned int blockIndex = glGetUniformBlockIndex(shader.ID, BLOCK_NAME);
+  if (blockIndex != GL_INVALID_INDEX)
+    glUniformBlockBinding(shader.ID, blockIndex, BINDING_POINT);
+}
+
+void FrameUniformBuffer::update(const FrameUniformData &data)
+{
+  glBindBuffer(GL_UNIFORM_BUFFER, UBO);
+  glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(FrameUniformData), &data);
+  glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
@@ -1,6 +1,17 @@
 #include "FrustumCuller.h"
 #include <algorithm>
 
+// Widest SIMD the build targets; x86-64 always has SSE, AVX needs the compiler flag (BACKROOMS_AVX)
+#if defined(__AVX__)
+#include <immintrin.h>
+#define FRUSTUM_SIMD_WIDTH 8
+#elif defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define FRUSTUM_SIMD_WIDTH 4
+#else
+#define FRUSTUM_SIMD_WIDTH 1
+#endif
+
 FrustumCuller::FrustumCuller()
 {
   // Initialize with identity frustum
@@ -59,41 +70,129 @@ void FrustumCuller::updateFrustum(const glm::mat4 &viewProjectionMatrix)
       plane.distance /= length;
     }
   }
+
+  for (size_t i = 0; i < planes.size(); ++i)
+  {
+    const glm::vec3 &normal = planes[i].normal;
+    signMasks[i] = (normal.x >= 0 ? 1 : 0) | (normal.y >= 0 ? 2 : 0) | (normal.z >= 0 ? 4 : 0);
+  }
 }
 
 bool FrustumCuller::isAABBVisible(const AABB &aabb) const
 {
   // Test AABB against all 6 frustum planes
-  for (const auto &plane : planes)
+  for (size_t i = 0; i < planes.size(); ++i)
   {
-    // Find the positive and negative vertices
-    glm::vec3 positiveVertex = aabb.min;
-    glm::vec3 negativeVertex = aabb.max;
+    // Positive vertex: the corner furthest along the plane normal
+    glm::vec3 positiveVertex((signMasks[i] & 1) ? aabb.max.x : aabb.min.x,
+                             (signMasks[i] & 2) ? aabb.max.y : aabb.min.y,
+                             (signMasks[i] & 4) ? aabb.max.z : aabb.min.z);
 
-    if (plane.normal.x >= 0)
-    {
-      positiveVertex.x = aabb.max.x;
-      negativeVertex.x = aabb.min.x;
-    }
-    if (plane.normal.y >= 0)
+    // If positive vertex is outside, AABB is completely outside
+    if (planes[i].distanceToPoint(positiveVertex) < 0)
     {
-      positiveVertex.y = aabb.max.y;
-      negativeVertex.y = aabb.min.y;
+      return false;
     }
-    if (plane.normal.z >= 0)
+  }
+
+  return true; // AABB is inside or intersecting
+}
+
+FrustumTest FrustumCuller::classifyAABB(const AABB &aabb) const
+{
+  FrustumTest result = FrustumTest::INSIDE;
+  for (size_t i = 0; i < planes.size(); ++i)
+  {
+    // Positive vertex outside: the whole box is. Negative vertex (the opposite corner) outside:
+    // the plane cuts through the box.
+    glm::vec3 positiveVertex((signMasks[i] & 1) ? aabb.max.x : aabb.min.x,
+                             (signMasks[i] & 2) ? aabb.max.y : aabb.min.y,
+                             (signMasks[i] & 4) ? aabb.max.z : aabb.min.z);
+    if (planes[i].distanceToPoint(positiveVertex) < 0)
+      return FrustumTest::OUTSIDE;
+
+    glm::vec3 negativeVertex((signMasks[i] & 1) ? aabb.min.x : aabb.max.x,
+                             (signMasks[i] & 2) ? aabb.min.y : aabb.max.y,
+                             (signMasks[i] & 4) ? aabb.min.z : aabb.max.z);
+    if (planes[i].distanceToPoint(negativeVertex) < 0)
+      result = FrustumTest::INTERSECTING;
+  }
+  return result;
+}
+
+void FrustumCuller::isAABBVisibleBatch(const AABBArray &boxes, std::vector<uint64_t> &visibleMask) const
+{
+  const size_t count = boxes.size();
+  visibleMask.assign((count + 63) / 64, 0);
+
+  // The sign masks fix, per plane, which array each coordinate of the positive vertex comes from,
+  // so the loops below never select per box
+  const float *cornerX[6], *cornerY[6], *cornerZ[6];
+  for (int p = 0; p < 6; ++p)
+  {
+    cornerX[p] = ((signMasks[p] & 1) ? boxes.maxX : boxes.minX).data();
+    cornerY[p] = ((signMasks[p] & 2) ? boxes.maxY : boxes.minY).data();
+    cornerZ[p] = ((signMasks[p] & 4) ? boxes.maxZ : boxes.minZ).data();
+  }
+
+  // Lanes are summed in the same order as Plane::distanceToPoint, so results match the scalar test.
+  // Batches start at multiples of their width, so one batch never straddles two mask words.
+  size_t i = 0;
+#if FRUSTUM_SIMD_WIDTH == 8
+  __m256 normalX[6], normalY[6], normalZ[6], distance[6];
+  for (int p = 0; p < 6; ++p)
+  {
+    normalX[p] = _mm256_set1_ps(planes[p].normal.x);
+    normalY[p] = _mm256_set1_ps(planes[p].normal.y);
+    normalZ[p] = _mm256_set1_ps(planes[p].normal.z);
+    distance[p] = _mm256_set1_ps(planes[p].distance);
+  }
+  const __m256 zero = _mm256_setzero_ps();
+  for (; i + 8 <= count; i += 8)
+  {
+    int outside = 0;
+    for (int p = 0; p < 6; ++p)
     {
-      positiveVertex.z = aabb.max.z;
-      negativeVertex.z = aabb.min.z;
+      __m256 dot = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(normalX[p], _mm256_loadu_ps(cornerX[p] + i)),
+                                               _mm256_mul_ps(normalY[p], _mm256_loadu_ps(cornerY[p] + i))),
+                                 _mm256_mul_ps(normalZ[p], _mm256_loadu_ps(cornerZ[p] + i)));
+      outside |= _mm256_movemask_ps(_mm256_cmp_ps(_mm256_add_ps(dot, distance[p]), zero, _CMP_LT_OQ));
     }
-
-    // If positive vertex is outside, AABB is completely outside
-    if (plane.distanceToPoint(positiveVertex) < 0)
+    visibleMask[i / 64] |= static_cast<uint64_t>(~outside & 0xFF) << (i % 64);
+  }
+#elif FRUSTUM_SIMD_WIDTH == 4
+  __m128 normalX[6], normalY[6], normalZ[6], distance[6];
+  for (int p = 0; p < 6; ++p)
+  {
+    normalX[p] = _mm_set1_ps(planes[p].normal.x);
+    normalY[p] = _mm_set1_ps(planes[p].normal.y);
+    normalZ[p] = _mm_set1_ps(planes[p].normal.z);
+    distance[p] = _mm_set1_ps(planes[p].distance);
+  }
+  const __m128 zero = _mm_setzero_ps();
+  for (; i + 4 <= count; i += 4)
+  {
+    int outside = 0;
+    for (int p = 0; p < 6; ++p)
     {
-      return false;
+      __m128 dot = _mm_add_ps(_mm_add_ps(_mm_mul_ps(normalX[p], _mm_loadu_ps(cornerX[p] + i)),
+                                         _mm_mul_ps(normalY[p], _mm_loadu_ps(cornerY[p] + i))),
+                              _mm_mul_ps(normalZ[p], _mm_loadu_ps(cornerZ[p] + i)));
+      outside |= _mm_movemask_ps(_mm_cmplt_ps(_mm_add_ps(dot, distance[p]), zero));
     }
+    visibleMask[i / 64] |= static_cast<uint64_t>(~outside & 0xF) << (i % 64);
   }
+#endif
 
-  return true; // AABB is inside or intersecting
+  // Whatever doesn't fill a whole batch
+  for (; i < count; ++i)
+  {
+    bool visible = true;
+    for (int p = 0; p < 6 && visible; ++p)
+      visible = !(planes[p].distanceToPoint(glm::vec3(cornerX[p][i], cornerY[p][i], cornerZ[p][i])) < 0);
+    if (visible)
+      visibleMask[i / 64] |= uint64_t(1) << (i % 64);
+  }
 }
 
 bool FrustumCuller::isPointVisible(const glm::vec3 &point) const
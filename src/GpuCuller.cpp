@@ -0,0 +1,165 @@
+#include "GpuCuller.h"
+#include <vector>
+
+static const int LOCAL_SIZE = 64; // local_size_x in chunkCull.comp
+
+bool GpuCuller::isSupported()
+{
+  return GLAD_GL_VERSION_4_3 != 0;
+}
+
+bool GpuCuller::init()
+{
+  if (!isSupported())
+  {
+    std::cout << "GPU culling unavailable: requires an OpenGL 4.3 context" << std::endl;
+    return false;
+  }
+
+  GLint linked = GL_FALSE;
+  std::unique_ptr<Shader> shader(new Shader("data/shaders/chunkCull.comp"));
+  glGetProgramiv(shader->ID, GL_LINK_STATUS, &linked);
+  if (!linked)
+  {
+    glDeleteProgram(shader->ID);
+    return false;
+  }
+  cullShader = std::move(shader);
+  for (int i = 0; i < 6; ++i)
+    planeUniforms[i] = cullShader->uniform("planes[" + std::to_string(i) + "]");
+  testFrustumUniform = cullShader->uniform("testFrustum");
+  chunkCountUniform = cullShader->uniform("chunkCount");
+  rangeUniform = cullShader->uniform("range");
+
+  glGenBuffers(1, &chunkBuffer);
+  glGenBuffers(1, &commandBuffer);
+  glGenBuffers(COUNTER_SLOTS + 1, counterBuffers);
+
+  for (unsigned int counterBuffer : counterBuffers)
+  {
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, counterBuffer);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(uint32_t), nullptr, GL_DYNAMIC_READ);
+  }
+  glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+  return true;
+}
+
+void GpuCuller::release()
+{
+  if (!cullShader)
+    return;
+
+  for (int slot = 0; slot < COUNTER_SLOTS; ++slot)
+  {
+    if (counterFences[slot])
+      glDeleteSync(counterFences[slot]);
+    counterFences[slot] = nullptr;
+  }
+  glDeleteBuffers(1, &chunkBuffer);
+  glDeleteBuffers(1, &commandBuffer);
+  glDeleteBuffers(COUNTER_SLOTS + 1, counterBuffers);
+  glDeleteProgram(cullShader->ID);
+
+  chunkBuffer = commandBuffer = 0;
+  for (unsigned int &counterBuffer : counterBuffers)
+    counterBuffer = 0;
+  nextCounter = 0;
+  cullShader.reset();
+  chunkCount = 0;
+}
+
+void GpuCuller::setChunks(const ChunkMeshBuilder &chunkMeshes)
+{
+  if (!cullShader)
+    return;
+
+  const auto &chunks = chunkMeshes.getChunks();
+  std::vector<GpuChunk> records(chunks.size());
+  for (size_t i = 0; i < chunks.size(); ++i)
+  {
+    const ChunkMesh &chunk = chunks[i];
+    records[i].boundsMin = glm::vec4(chunk.bounds.min, 0.0f);
+    records[i].boundsMax = glm::vec4(chunk.bounds.max, 0.0f);
+    records[i].firstIndex = chunk.firstIndex;
+    records[i].indexCount = chunk.totalIndexCount();
+    records[i].baseVertex = chunk.baseVertex;
+    records[i].padding = 0;
+  }
+
+  chunkCount = static_cast<int>(records.size());
+  VAO = chunkMeshes.getVAO();
+
+  glBindBuffer(GL_SHADER_STORAGE_BUFFER, chunkBuffer);
+  glBufferData(GL_SHADER_STORAGE_BUFFER, records.size() * sizeof(GpuChunk), records.data(), GL_STATIC_DRAW);
+  glBindBuffer(GL_SHADER_STORAGE_BUFFER, commandBuffer);
+  glBufferData(GL_SHADER_STORAGE_BUFFER, records.size() * sizeof(DrawElementsIndirectCommand), nullptr, GL_DYNAMIC_DRAW);
+  glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
+
+void GpuCuller::cull(const FrustumCuller &frustum, bool testFrustum, const glm::vec2 &rangeMin, const glm::vec2 &rangeMax)
+{
+  if (!cullShader || chunkCount == 0)
+    return;
+
+  // Pick up the counts the GPU is done with, oldest first so the newest wins; never wait. Unsignalled
+  // fences are polled again next frame. The first poll flushes the fence, since a headless run never
+  // swaps buffers and nothing else would submit it.
+  for (int i = 0; i < COUNTER_SLOTS; ++i)
+  {
+    int slot = (nextCounter + i) % COUNTER_SLOTS;
+    if (!counterFences[slot])
+      continue;
+    GLenum status = glClientWaitSync(counterFences[slot], counterFlushed[slot] ? 0 : GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+    counterFlushed[slot] = true;
+    if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED)
+      continue;
+
+    uint32_t count = 0;
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, counterBuffers[slot]);
+    glGetBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof(count), &count);
+    visibleCount = static_cast<int>(count);
+    glDeleteSync(counterFences[slot]);
+    counterFences[slot] = nullptr;
+  }
+
+  // With every slot still in flight this frame counts into the spare, which is never read
+  int slot = counterFences[nextCounter] ? COUNTER_SLOTS : nextCounter;
+  const uint32_t zero = 0;
+  glBindBuffer(GL_SHADER_STORAGE_BUFFER, counterBuffers[slot]);
+  glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof(zero), &zero);
+  glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+  cullShader->use();
+  const auto &planes = frustum.getPlanes();
+  for (int i = 0; i < 6; ++i)
+    cullShader->setVec4(planeUniforms[i], glm::vec4(planes[i].normal, planes[i].distance));
+  cullShader->setBool(testFrustumUniform, testFrustum);
+  cullShader->setInt(chunkCountUniform, chunkCount);
+  cullShader->setVec4(rangeUniform, glm::vec4(rangeMin.x, rangeMin.y, rangeMax.x, rangeMax.y));
+
+  glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, chunkBuffer);
+  glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, commandBuffer);
+  glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, counterBuffers[slot]);
+  glDispatchCompute((chunkCount + LOCAL_SIZE - 1) / LOCAL_SIZE, 1, 1);
+
+  // Commands are read by the indirect draw, the counter by glGetBufferSubData
+  glMemoryBarrier(GL_COMMAND_BARRIER_BIT | GL_BUFFER_UPDATE_BARRIER_BIT);
+  if (slot < COUNTER_SLOTS)
+  {
+    counterFences[slot] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    counterFlushed[slot] = false;
+    nextCounter = (slot + 1) % COUNTER_SLOTS;
+  }
+}
+
+void GpuCuller::draw() const
+{
+  if (!cullShader || chunkCount == 0)
+    return;
+
+  glBindVertexArray(VAO);
+  glBindBuffer(GL_DRAW_INDIRECT_BUFFER, commandBuffer);
+  glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, nullptr, chunkCount, 0);
+  glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+  glBindVertexArray(0);
+}
@@ -0,0 +1,148 @@
+#include "HeadlessContext.h"
+#include <iostream>
+
+#ifdef BACKROOMS_HAS_EGL
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include <cstring>
+
+static EGLDisplay openDisplay(bool &surfaceless)
+{
+  // Surfaceless needs no window system at all; fall back to the default display (pbuffer) otherwise
+  const char *extensions = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+  auto getPlatformDisplay = (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+  if (extensions && std::strstr(extensions, "EGL_MESA_platform_surfaceless") && getPlatformDisplay)
+  {
+    EGLDisplay display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+    if (display != EGL_NO_DISPLAY && eglInitialize(display, nullptr, nullptr))
+    {
+      surfaceless = true;
+      return display;
+    }
+  }
+
+  EGLDisplay display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+  if (display != EGL_NO_DISPLAY && eglInitialize(display, nullptr, nullptr))
+  {
+    surfaceless = false;
+    return display;
+  }
+  return EGL_NO_DISPLAY;
+}
+
+bool HeadlessContext::create()
+{
+  bool surfaceless = false;
+  EGLDisplay eglDisplay = openDisplay(surfaceless);
+  if (eglDisplay == EGL_NO_DISPLAY)
+  {
+    std::cout << "Headless: no EGL display available" << std::endl;
+    return false;
+  }
+  display = eglDisplay;
+
+  if (!eglBindAPI(EGL_OPENGL_API))
+  {
+    std::cout << "Headless: EGL has no desktop OpenGL support" << std::endl;
+    destroy();
+    return false;
+  }
+
+  const EGLint configAttribs[] = {
+      EGL_SURFACE_TYPE, surfaceless ? 0 : EGL_PBUFFER_BIT,
+      EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+      EGL_RED_SIZE, 8, EGL_GREEN_SIZE, 8, EGL_BLUE_SIZE, 8,
+      EGL_NONE};
+  EGLConfig config = nullptr;
+  EGLint configCount = 0;
+  if (!eglChooseConfig(eglDisplay, configAttribs, &config, 1, &configCount) || configCount == 0)
+  {
+    // Surfaceless contexts don't need a config (EGL_KHR_no_config_context)
+    if (!surfaceless)
+    {
+      std::cout << "Headless: no suitable EGL config" << std::endl;
+      destroy();
+      return false;
+    }
+    config = nullptr;
+  }
+
+  // Prefer 4.3 for GPU-driven culling, as the windowed path does
+  const EGLint versions[2][2] = {{4, 3}, {3, 3}};
+  EGLContext eglContext = EGL_NO_CONTEXT;
+  for (const auto &version : versions)
+  {
+    const EGLint contextAttribs[] = {
+        EGL_CONTEXT_MAJOR_VERSION, version[0],
+        EGL_CONTEXT_MINOR_VERSION, version[1],
+        EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+        EGL_NONE};
+    eglContext = eglCreateContext(eglDisplay, config, EGL_NO_CONTEXT, contextAttribs);
+    if (eglContext != EGL_NO_CONTEXT)
+      break;
+  }
+  if (eglContext == EGL_NO_CONTEXT)
+  {
+    std::cout << "Headless: failed to create an OpenGL 3.3+ core context" << std::endl;
+    destroy();
+    return false;
+  }
+  context = eglContext;
+
+  EGLSurface eglSurface = EGL_NO_SURFACE;
+  if (!surfaceless)
+  {
+    const EGLint pbufferAttribs[] = {EGL_WIDTH, 1, EGL_HEIGHT, 1, EGL_NONE};
+    eglSurface = eglCreatePbufferSurface(eglDisplay, config, pbufferAttribs);
+    surface = eglSurface;
+  }
+
+  if (!eglMakeCurrent(eglDisplay, eglSurface, eglSurface, eglContext))
+  {
+    std::cout << "Headless: failed to make the context current" << std::endl;
+    destroy();
+    return false;
+  }
+
+  std::cout << "Headless: " << (surfaceless ? "EGL surfaceless" : "EGL pbuffer") << " context" << std::endl;
+  return true;
+}
+
+void HeadlessContext::destroy()
+{
+  if (!display)
+    return;
+
+  eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+  if (surface)
+    eglDestroySurface(display, surface);
+  if (context)
+    eglDestroyContext(display, context);
+  eglTerminate(display);
+
+  display = context = surface = nullptr;
+}
+
+void *HeadlessContext::getProcAddress(const char *name)
+{
+  return reinterpret_cast<void *>(eglGetProcAddress(name));
+}
+
+#else
+
+bool HeadlessContext::create()
+{
+  std::cout << "Headless: this build has no EGL support" << std::endl;
+  return false;
+}
+
+void HeadlessContext::destroy()
+{
+}
+
+void *HeadlessContext::getProcAddress(const char *)
+{
+  return nullptr;
+}
+
+#endif
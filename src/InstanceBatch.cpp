@@ -0,0 +1,67 @@
+#include "InstanceBatch.h"
+#include <algorithm>
+
+void InstanceBatch::init(const Mesh &mesh)
+{
+  release();
+  indexCount = static_cast<unsigned int>(mesh.indices.size());
+
+  glGenVertexArrays(1, &VAO);
+  glGenBuffers(1, &instanceVBO);
+
+  glBindVertexArray(VAO);
+
+  // Per-vertex attributes come from the template mesh
+  glBindBuffer(GL_ARRAY_BUFFER, mesh.getVBO());
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh.getEBO());
+  glEnableVertexAttribArray(0);
+  glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void *)0);
+  glEnableVertexAttribArray(1);
+  glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void *)offsetof(Vertex, Normal));
+  glEnableVertexAttribArray(2);
+  glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void *)offsetof(Vertex, TexCoords));
+
+  // Per-instance packed piece: integer cell coordinates and the type/orientation bits
+  glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+  glEnableVertexAttribArray(INSTANCE_ATTRIB_LOCATION);
+  glVertexAttribIPointer(INSTANCE_ATTRIB_LOCATION, 2, GL_SHORT, sizeof(PackedPiece), (void *)offsetof(PackedPiece, cellX));
+  glVertexAttribDivisor(INSTANCE_ATTRIB_LOCATION, 1);
+  glEnableVertexAttribArray(INSTANCE_ATTRIB_LOCATION + 1);
+  glVertexAttribIPointer(INSTANCE_ATTRIB_LOCATION + 1, 1, GL_UNSIGNED_INT, sizeof(PackedPiece), (void *)offsetof(PackedPiece, bits));
+  glVertexAttribDivisor(INSTANCE_ATTRIB_LOCATION + 1, 1);
+
+  glBindVertexArray(0);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void InstanceBatch::release()
+{
+  if (VAO != 0)
+  {
+    glDeleteVertexArrays(1, &VAO);
+    glDeleteBuffers(1, &instanceVBO);
+  }
+  VAO = 0;
+  instanceVBO = 0;
+  capacity = 0;
+}
+
+bool InstanceBatch::Draw()
+{
+  if (instances.empty() || VAO == 0)
+    return false;
+
+  glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+  if (instances.size() > capacity)
+  {
+    // Grow geometrically so the buffer settles after a few frames
+    capacity = std::max(instances.size(), capacity * 2);
+  }
+  // Orphan last frame's storage so the driver doesn't stall on in-flight draws
+  glBufferData(GL_ARRAY_BUFFER, capacity * sizeof(PackedPiece), nullptr, GL_STREAM_DRAW);
+  glBufferSubData(GL_ARRAY_BUFFER, 0, instances.size() * sizeof(PackedPiece), instances.data());
+
+  glBindVertexArray(VAO);
+  glDrawElementsInstanced(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, 0, static_cast<GLsizei>(instances.size()));
+  return true;
+}
@@ -0,0 +1,312 @@
+#include "MazeFile.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace MazeFileFormat;
+
+namespace
+{
+  // Explicit little-endian reads and writes keep the format independent of the host
+  uint16_t read16(const uint8_t *p) { return static_cast<uint16_t>(p[0] | (p[1] << 8)); }
+  uint32_t read32(const uint8_t *p) { return read16(p) | (static_cast<uint32_t>(read16(p + 2)) << 16); }
+  uint64_t read64(const uint8_t *p) { return read32(p) | (static_cast<uint64_t>(read32(p + 4)) << 32); }
+
+  void write16(std::vector<uint8_t> &out, uint16_t value)
+  {
+    out.push_back(static_cast<uint8_t>(value));
+    out.push_back(static_cast<uint8_t>(value >> 8));
+  }
+  void write32(std::vector<uint8_t> &out, uint32_t value)
+  {
+    write16(out, static_cast<uint16_t>(value));
+    write16(out, static_cast<uint16_t>(value >> 16));
+  }
+  void write64(std::vector<uint8_t> &out, uint64_t value)
+  {
+    write32(out, static_cast<uint32_t>(value));
+    write32(out, static_cast<uint32_t>(value >> 32));
+  }
+
+  // 3-bit cell value: CellType in bits 0-1, visited in bit 2
+  uint8_t cellValue(const BitGrid &typeLow, const BitGrid &typeHigh, const BitGrid &visited, int x, int z)
+  {
+    if (x >= typeLow.getWidth() || z >= typeLow.getHeight())
+      return 0;
+    return static_cast<uint8_t>(typeLow.test(x, z) | (typeHigh.test(x, z) << 1) | (visited.test(x, z) << 2));
+  }
+
+  void encodeChunk(const BitGrid &typeLow, const BitGrid &typeHigh, const BitGrid &visited, int originX, int originZ,
+                   int chunkSize, std::vector<uint8_t> &payload, Encoding &encoding)
+  {
+    std::vector<uint8_t> cells;
+    cells.reserve(static_cast<size_t>(chunkSize) * chunkSize);
+    for (int z = 0; z < chunkSize; ++z)
+      for (int x = 0; x < chunkSize; ++x)
+        cells.push_back(cellValue(typeLow, typeHigh, visited, originX + x, originZ + z));
+
+    std::vector<uint8_t> rle;
+    for (size_t i = 0; i < cells.size();)
+    {
+      size_t run = 1;
+      while (i + run < cells.size() && cells[i + run] == cells[i] && run < 256)
+        run++;
+      rle.push_back(cells[i]);
+      rle.push_back(static_cast<uint8_t>(run - 1));
+      i += run;
+    }
+
+    std::vector<uint8_t> packed;
+    for (int plane = 0; plane < 3; ++plane)
+    {
+      for (int z = 0; z < chunkSize; ++z)
+      {
+        uint16_t bits = 0;
+        for (int x = 0; x < chunkSize; ++x)
+          bits |= static_cast<uint16_t>(((cells[z * chunkSize + x] >> plane) & 1) << x);
+        write16(packed, bits);
+      }
+    }
+
+    if (rle.size() < packed.size())
+    {
+      payload.swap(rle);
+      encoding = ENCODING_RLE;
+    }
+    else
+    {
+      payload.swap(packed);
+      encoding = ENCODING_BITPACKED;
+    }
+  }
+}
+
+MazeFile::~MazeFile()
+{
+#ifdef _WIN32
+  if (data)
+    UnmapViewOfFile(data);
+  if (mappingHandle)
+    CloseHandle(mappingHandle);
+  if (fileHandle && fileHandle != INVALID_HANDLE_VALUE)
+    CloseHandle(fileHandle);
+#else
+  if (data)
+    munmap(const_cast<uint8_t *>(data), size);
+#endif
+}
+
+std::shared_ptr<const MazeFile> MazeFile::open(const std::string &path)
+{
+  std::shared_ptr<MazeFile> file(new MazeFile());
+  if (!file->map(path) || !file->validate(path))
+    return nullptr;
+  return file;
+}
+
+bool MazeFile::map(const std::string &path)
+{
+#ifdef _WIN32
+  fileHandle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  LARGE_INTEGER fileSize;
+  if (fileHandle == INVALID_HANDLE_VALUE || !GetFileSizeEx(fileHandle, &fileSize) || fileSize.QuadPart == 0)
+  {
+    std::cout << "Failed to open maze file: " << path << std::endl;
+    return false;
+  }
+  size = static_cast<size_t>(fileSize.QuadPart);
+  mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if (mappingHandle)
+    data = static_cast<const uint8_t *>(MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0));
+#else
+  int fd = ::open(path.c_str(), O_RDONLY);
+  struct stat info;
+  if (fd < 0 || fstat(fd, &info) != 0 || info.st_size == 0)
+  {
+    std::cout << "Failed to open maze file: " << path << std::endl;
+    if (fd >= 0)
+      close(fd);
+    return false;
+  }
+  size = static_cast<size_t>(info.st_size);
+  void *mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd); // the mapping keeps the file alive
+  if (mapping != MAP_FAILED)
+    data = static_cast<const uint8_t *>(mapping);
+#endif
+
+  if (!data)
+  {
+    std::cout << "Failed to map maze file: " << path << std::endl;
+    return false;
+  }
+  return true;
+}
+
+bool MazeFile::validate(const std::string &path)
+{
+  if (size < HEADER_SIZE || std::memcmp(data, MAGIC, sizeof(MAGIC)) != 0)
+  {
+    std::cout << "Not a maze file: " << path << std::endl;
+    return false;
+  }
+  uint16_t version = read16(data + 4);
+  if (version != VERSION || read16(data + 6) != HEADER_SIZE)
+  {
+    std::cout << "Unsupported maze file version " << version << ": " << path << std::endl;
+    return false;
+  }
+
+  header.width = static_cast<int>(read32(data + 8));
+  header.height = static_cast<int>(read32(data + 12));
+  header.seed = read32(data + 16);
+  header.chunkSize = static_cast<int>(read32(data + 20));
+  header.chunksX = static_cast<int>(read32(data + 24));
+  header.chunksZ = static_cast<int>(read32(data + 28));
+  header.directoryOffset = read64(data + 32);
+
+  bool valid = header.width > 0 && header.height > 0 && header.chunkSize > 0 && header.chunkSize <= 16 &&
+               header.chunksX == (header.width + header.chunkSize - 1) / header.chunkSize &&
+               header.chunksZ == (header.height + header.chunkSize - 1) / header.chunkSize;
+  uint64_t directorySize = static_cast<uint64_t>(header.chunksX) * header.chunksZ * DIRECTORY_ENTRY_SIZE;
+  if (!valid || header.directoryOffset > size || directorySize > size - header.directoryOffset)
+  {
+    std::cout << "Corrupt maze file header: " << path << std::endl;
+    return false;
+  }
+
+  // Check every payload lies inside the file once, so decoding never has to
+  for (uint64_t i = 0; i < directorySize / DIRECTORY_ENTRY_SIZE; ++i)
+  {
+    const uint8_t *entry = data + header.directoryOffset + i * DIRECTORY_ENTRY_SIZE;
+    uint64_t offset = read64(entry);
+    uint32_t length = read32(entry + 8);
+    if (offset > size || length > size - offset || entry[12] > ENCODING_RLE)
+    {
+      std::cout << "Corrupt maze file directory: " << path << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+bool MazeFile::decodeChunk(int chunkX, int chunkZ, BitGrid &typeLow, BitGrid &typeHigh, BitGrid &visited) const
+{
+  if (chunkX < 0 || chunkZ < 0 || chunkX >= header.chunksX || chunkZ >= header.chunksZ)
+    return false;
+
+  const int chunkSize = header.chunkSize;
+  const uint8_t *entry = data + header.directoryOffset + (static_cast<uint64_t>(chunkZ) * header.chunksX + chunkX) * DIRECTORY_ENTRY_SIZE;
+  const uint8_t *payload = data + read64(entry);
+  uint32_t length = read32(entry + 8);
+  int originX = chunkX * chunkSize;
+  int originZ = chunkZ * chunkSize;
+  int endX = std::min(originX + chunkSize, typeLow.getWidth());
+  int endZ = std::min(originZ + chunkSize, typeLow.getHeight());
+
+  auto store = [&](int x, int z, uint8_t value)
+  {
+    if (x < endX && z < endZ)
+    {
+      typeLow.assign(x, z, value & 1);
+      typeHigh.assign(x, z, value & 2);
+      visited.assign(x, z, value & 4);
+    }
+  };
+
+  if (entry[12] == ENCODING_BITPACKED)
+  {
+    if (length != 3u * chunkSize * 2)
+      return false;
+    BitGrid *planes[3] = {&typeLow, &typeHigh, &visited};
+    for (int plane = 0; plane < 3; ++plane)
+    {
+      for (int z = originZ; z < endZ; ++z)
+      {
+        uint16_t bits = read16(payload + (plane * chunkSize + (z - originZ)) * 2);
+        for (int x = originX; x < endX; ++x)
+          planes[plane]->assign(x, z, (bits >> (x - originX)) & 1);
+      }
+    }
+    return true;
+  }
+
+  // RLE: runs must cover the chunk exactly
+  int cell = 0;
+  const int cellCount = chunkSize * chunkSize;
+  for (uint32_t i = 0; i + 1 < length && cell < cellCount; i += 2)
+  {
+    uint8_t value = payload[i];
+    int run = payload[i + 1] + 1;
+    for (int end = std::min(cell + run, cellCount); cell < end; ++cell)
+      store(originX + cell % chunkSize, originZ + cell / chunkSize, value);
+  }
+  return cell == cellCount;
+}
+
+bool MazeFile::write(const std::string &path, uint32_t seed, int chunkSize,
+                     const BitGrid &typeLow, const BitGrid &typeHigh, const BitGrid &visited)
+{
+  const int width = typeLow.getWidth();
+  const int height = typeLow.getHeight();
+  const int chunksX = (width + chunkSize - 1) / chunkSize;
+  const int chunksZ = (height + chunkSize - 1) / chunkSize;
+  const uint64_t directoryOffset = HEADER_SIZE;
+  const uint64_t payloadOffset = directoryOffset + static_cast<uint64_t>(chunksX) * chunksZ * DIRECTORY_ENTRY_SIZE;
+
+  std::vector<uint8_t> out;
+  out.insert(out.end(), MAGIC, MAGIC + sizeof(MAGIC));
+  write16(out, VERSION);
+  write16(out, static_cast<uint16_t>(HEADER_SIZE));
+  write32(out, static_cast<uint32_t>(width));
+  write32(out, static_cast<uint32_t>(height));
+  write32(out, seed);
+  write32(out, static_cast<uint32_t>(chunkSize));
+  write32(out, static_cast<uint32_t>(chunksX));
+  write32(out, static_cast<uint32_t>(chunksZ));
+  write64(out, directoryOffset);
+
+  // Payloads are encoded first so the directory can be written in front of them
+  std::vector<uint8_t> payloads;
+  std::vector<uint8_t> payload;
+  for (int chunkZ = 0; chunkZ < chunksZ; ++chunkZ)
+  {
+    for (int chunkX = 0; chunkX < chunksX; ++chunkX)
+    {
+      Encoding encoding;
+      encodeChunk(typeLow, typeHigh, visited, chunkX * chunkSize, chunkZ * chunkSize, chunkSize, payload, encoding);
+      write64(out, payloadOffset + payloads.size());
+      write32(out, static_cast<uint32_t>(payload.size()));
+      out.push_back(encoding);
+      out.insert(out.end(), 3, 0);
+      payloads.insert(payloads.end(), payload.begin(), payload.end());
+    }
+  }
+
+  std::ofstream file(path, std::ios::binary | std::ios::trunc);
+  if (!file)
+  {
+    std::cout << "Failed to create maze file: " << path << std::endl;
+    return false;
+  }
+  file.write(reinterpret_cast<const char *>(out.data()), static_cast<std::streamsize>(out.size()));
+  file.write(reinterpret_cast<const char *>(payloads.data()), static_cast<std::streamsize>(payloads.size()));
+  if (!file)
+  {
+    std::cout << "Failed to write maze file: " << path << std::endl;
+    return false;
+  }
+  return true;
+}
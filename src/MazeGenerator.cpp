@@ -1,46 +1,57 @@
 #include "MazeGenerator.h"
+#include "MazeFile.h"
 #include <algorithm>
+#include <chrono>
+#include <utility>
 #include <iostream>
-#include <set>
 #include <cmath>
+#include <functional>
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
 #endif
 
-MazeGenerator::MazeGenerator(int width, int height, unsigned int seed)
-    : width(width), height(height), rng(seed == 0 ? std::random_device{}() : seed)
+using PassClock = std::chrono::steady_clock;
+
+// Adds the time since `begin` to a pass total and restarts the clock for the next pass
+static void endPass(double &totalMs, PassClock::time_point &begin)
 {
-  cells.resize(width * height);
+  PassClock::time_point now = PassClock::now();
+  totalMs += std::chrono::duration<double, std::milli>(now - begin).count();
+  begin = now;
+}
 
-  // Initialize all cells as walls
-  for (int z = 0; z < height; ++z)
-  {
-    for (int x = 0; x < width; ++x)
-    {
-      int index = getIndex(x, z);
-      cells[index].type = CellType::WALL;
-      cells[index].position = glm::vec3(x * 2.0f, 0.0f, z * 2.0f);
-      cells[index].visited = false;
-    }
-  }
+MazeGenerator::MazeGenerator(int width, int height, unsigned int seed)
+    : width(width), height(height), seed(seed == 0 ? std::random_device{}() : seed), rng(this->seed)
+{
+  // All cells start as unvisited walls (all bits zero)
+  typeBits[0] = BitGrid(width, height);
+  typeBits[1] = BitGrid(width, height);
+  visitedBits = BitGrid(width, height);
 }
 
 void MazeGenerator::generateMaze()
 {
+  decodeAll();
+
   // Start carving from center, but ensure odd coordinates for proper maze generation
   int startX = (width / 2) | 1;  // Make odd
   int startZ = (height / 2) | 1; // Make odd
 
+  PassClock::time_point passBegin = PassClock::now();
   carvePath(startX, startZ);
+  endPass(passTimings.mazeMs, passBegin);
 
   // Add some randomness for backrooms feel
   std::uniform_real_distribution<float> chance(0.0f, 1.0f);
-  for (int i = 0; i < (int)cells.size(); ++i)
+  for (int z = 0; z < height; ++z)
   {
-    if (cells[i].type == CellType::WALL && chance(rng) < 0.05f)
+    for (int x = 0; x < width; ++x)
     {
-      cells[i].type = CellType::FLOOR;
+      if (isWall(x, z) && chance(rng) < 0.05f)
+      {
+        setCellType(x, z, CellType::FLOOR);
+      }
     }
   }
 }
@@ -63,58 +74,72 @@ void MazeGenerator::generateBackroomsMaze()
   const int MIN_CUSTOM_ROOM_RADIUS = 2, MAX_CUSTOM_ROOM_RADIUS = 6; // Smaller custom rooms
 
   // Initialize all cells as walls (visited = false means wall, visited = true means floor)
-  for (auto &cell : cells)
+  discardFile();
+  typeBits[0].fill(false);
+  typeBits[1].fill(false);
+  visitedBits.fill(false);
+
+  // Cells taken into any of the mazes: one bit per cell plus a running count
+  BitGrid inMaze(width, height);
+  int mazeCells = 0;
+  auto addToMaze = [&](int cellX, int cellZ)
   {
-    cell.type = CellType::WALL;
-    cell.visited = false;
-  }
-
-  std::set<std::pair<int, int>> visitedCells;
+    if (!inMaze.test(cellX, cellZ))
+    {
+      inMaze.set(cellX, cellZ);
+      mazeCells++;
+    }
+  };
   int targetCells = static_cast<int>(width * height * MAZE_FILL_PERCENTAGE);
 
   std::uniform_int_distribution<int> xDist(0, width - 1);
   std::uniform_int_distribution<int> zDist(0, height - 1);
   std::uniform_real_distribution<float> randomFloat(0.0f, 1.0f);
+  PassClock::time_point passBegin = PassClock::now();
 
   // Generate multiple overlapping mazes using Prim's algorithm (exact Python translation)
   for (int mazeNum = 0; mazeNum < NUM_MAZES; ++mazeNum)
   {
-    if (static_cast<int>(visitedCells.size()) >= targetCells)
+    if (mazeCells >= targetCells)
       break;
 
     int x = xDist(rng);
     int z = zDist(rng);
 
-    visitedCells.insert({x, z});
-    std::vector<std::pair<int, int>> frontier;
+    addToMaze(x, z);
+    std::vector<glm::ivec2> frontier;
     frontier.push_back({x, z});
 
-    while (static_cast<int>(visitedCells.size()) < targetCells)
+    while (mazeCells < targetCells)
     {
       if (frontier.empty())
         break;
 
-      // Pick random cell from frontier
-      int idx = std::uniform_int_distribution<int>(0, frontier.size() - 1)(rng);
-      auto currentCell = frontier[idx];
-      frontier.erase(frontier.begin() + idx);
+      // Pick random cell from frontier and swap-remove it in O(1). Every pick queues at most one
+      // neighbour, so the frontier never holds more than one cell and this picks exactly what the
+      // old order-preserving erase did; the draw is kept (even though it is always 0) so the RNG
+      // stream, and with it every existing seed's map, is unchanged.
+      int idx = std::uniform_int_distribution<int>(0, static_cast<int>(frontier.size()) - 1)(rng);
+      glm::ivec2 currentCell = frontier[idx];
+      frontier[idx] = frontier.back();
+      frontier.pop_back();
 
-      x = currentCell.first;
-      z = currentCell.second;
+      x = currentCell.x;
+      z = currentCell.y;
 
-      visitedCells.insert({x, z});
-      cells[getIndex(x, z)].visited = true;
-      cells[getIndex(x, z)].type = CellType::FLOOR;
+      addToMaze(x, z);
+      visitedBits.set(x, z);
+      setCellType(x, z, CellType::FLOOR);
 
       // Check neighbors exactly like Python
       std::vector<std::pair<int, int>> neighbors;
-      if (x > 1 && visitedCells.find({x - 2, z}) == visitedCells.end())
+      if (x > 1 && !inMaze.test(x - 2, z))
         neighbors.push_back({x - 2, z});
-      if (x < width - 2 && visitedCells.find({x + 2, z}) == visitedCells.end())
+      if (x < width - 2 && !inMaze.test(x + 2, z))
         neighbors.push_back({x + 2, z});
-      if (z > 1 && visitedCells.find({x, z - 2}) == visitedCells.end())
+      if (z > 1 && !inMaze.test(x, z - 2))
         neighbors.push_back({x, z - 2});
-      if (z < height - 2 && visitedCells.find({x, z + 2}) == visitedCells.end())
+      if (z < height - 2 && !inMaze.test(x, z + 2))
         neighbors.push_back({x, z + 2});
 
       if (!neighbors.empty())
@@ -128,44 +153,87 @@ void MazeGenerator::generateBackroomsMaze()
         int betweenZ = (z + nz) / 2;
 
         if (randomFloat(rng) > STOP_COLLISION_PROBABILITY ||
-            !cells[getIndex(betweenX, betweenZ)].visited)
+            !visitedBits.test(betweenX, betweenZ))
         {
           frontier.push_back({nx, nz});
-          cells[getIndex(betweenX, betweenZ)].visited = true;
-          cells[getIndex(betweenX, betweenZ)].type = CellType::FLOOR;
+          visitedBits.set(betweenX, betweenZ);
+          setCellType(betweenX, betweenZ, CellType::FLOOR);
         }
       }
     }
   }
 
+  endPass(passTimings.mazeMs, passBegin);
+
   // Generate rooms (exact Python translation)
   generateRooms(NUM_ROOMS, ROOM_WIDTH_MIN, ROOM_WIDTH_MAX, ROOM_HEIGHT_MIN, ROOM_HEIGHT_MAX);
+  endPass(passTimings.roomsMs, passBegin);
 
   // Generate pillar rooms (exact Python translation)
   generatePillarRooms(NUM_PILLAR_ROOMS, PILLAR_ROOM_WIDTH_MIN, PILLAR_ROOM_WIDTH_MAX,
                       PILLAR_ROOM_HEIGHT_MIN, PILLAR_ROOM_HEIGHT_MAX,
                       PILLAR_SPACING_MIN, PILLAR_SPACING_MAX);
+  endPass(passTimings.pillarRoomsMs, passBegin);
 
   // Generate custom shaped rooms (exact Python translation)
   generateCustomRooms(NUM_CUSTOM_ROOMS, MIN_NUM_SIDES, MAX_NUM_SIDES,
                       MIN_CUSTOM_ROOM_RADIUS, MAX_CUSTOM_ROOM_RADIUS);
+  endPass(passTimings.customRoomsMs, passBegin);
 
   std::cout << "Generated backrooms-style maze with " << width << "x" << height << " cells" << std::endl;
 }
 
 void MazeGenerator::generateChunk(int chunkX, int chunkZ)
 {
-  generateBackroomsLayout(chunkX, chunkZ);
+  generateChunk(chunkX, chunkZ, chunkX, chunkZ);
 }
 
-void MazeGenerator::generateBackroomsLayout(int chunkX, int chunkZ)
+void MazeGenerator::generateChunk(int chunkX, int chunkZ, int slotX, int slotZ)
+{
+  decodeAll();
+
+  // Start from solid wall so the result never depends on what was in the slot before
+  int startX = slotX * CHUNK_SIZE;
+  int startZ = slotZ * CHUNK_SIZE;
+  for (int z = startZ; z < startZ + CHUNK_SIZE; ++z)
+  {
+    for (int x = startX; x < startX + CHUNK_SIZE; ++x)
+    {
+      if (isValidCell(x, z))
+      {
+        setCellType(x, z, CellType::WALL);
+        visitedBits.reset(x, z);
+      }
+    }
+  }
+
+  std::mt19937 chunkRng(chunkSeed(seed, chunkX, chunkZ));
+  generateBackroomsLayout(slotX, slotZ, chunkRng);
+}
+
+uint32_t MazeGenerator::chunkSeed(uint32_t seed, int chunkX, int chunkZ)
+{
+  // splitmix64 finaliser over the packed inputs; negative coordinates hash like any other
+  uint64_t h = (static_cast<uint64_t>(seed) << 32) ^
+               (static_cast<uint64_t>(static_cast<uint32_t>(chunkX)) * 0x9E3779B97F4A7C15ull) ^
+               (static_cast<uint64_t>(static_cast<uint32_t>(chunkZ)) * 0xC2B2AE3D27D4EB4Full);
+  h ^= h >> 30;
+  h *= 0xBF58476D1CE4E5B9ull;
+  h ^= h >> 27;
+  h *= 0x94D049BB133111EBull;
+  h ^= h >> 31;
+  return static_cast<uint32_t>(h ^ (h >> 32));
+}
+
+void MazeGenerator::generateBackroomsLayout(int slotX, int slotZ, std::mt19937 &chunkRng)
 {
   // Generate a backrooms-style layout for this chunk
   std::uniform_real_distribution<float> roomChance(0.0f, 1.0f);
   std::uniform_int_distribution<int> roomSize(3, 8);
 
-  int startX = chunkX * CHUNK_SIZE;
-  int startZ = chunkZ * CHUNK_SIZE;
+  int startX = slotX * CHUNK_SIZE;
+  int startZ = slotZ * CHUNK_SIZE;
+  PassClock::time_point passBegin = PassClock::now();
 
   // Create a grid of rooms and corridors
   for (int z = 0; z < CHUNK_SIZE; z += 4)
@@ -175,10 +243,10 @@ void MazeGenerator::generateBackroomsLayout(int chunkX, int chunkZ)
       int worldX = startX + x;
       int worldZ = startZ + z;
 
-      if (roomChance(rng) < 0.7f)
+      if (roomChance(chunkRng) < 0.7f)
       { // 70% chance for room
-        int roomW = std::min(roomSize(rng), CHUNK_SIZE - x);
-        int roomH = std::min(roomSize(rng), CHUNK_SIZE - z);
+        int roomW = std::min(roomSize(chunkRng), CHUNK_SIZE - x);
+        int roomH = std::min(roomSize(chunkRng), CHUNK_SIZE - z);
 
         // Carve out room
         for (int rz = 0; rz < roomH; ++rz)
@@ -187,23 +255,25 @@ void MazeGenerator::generateBackroomsLayout(int chunkX, int chunkZ)
           {
             if (isValidCell(worldX + rx, worldZ + rz))
             {
-              int index = getIndex(worldX + rx, worldZ + rz);
-              cells[index].type = CellType::FLOOR;
+              setCellType(worldX + rx, worldZ + rz, CellType::FLOOR);
             }
           }
         }
       }
     }
   }
+  endPass(passTimings.roomsMs, passBegin);
 
-  addCorridors(chunkX, chunkZ);
+  addCorridors(slotX, slotZ);
+  endPass(passTimings.corridorsMs, passBegin);
 }
 
-void MazeGenerator::addCorridors(int chunkX, int chunkZ)
+void MazeGenerator::addCorridors(int slotX, int slotZ)
 {
-  int startX = chunkX * CHUNK_SIZE;
-  int startZ = chunkZ * CHUNK_SIZE;
+  int startX = slotX * CHUNK_SIZE;
+  int startZ = slotZ * CHUNK_SIZE;
 
+  // Corridors span the whole chunk on local rows/columns 0 and 8, so they continue into every neighbour
   // Add horizontal corridors
   for (int z = 0; z < CHUNK_SIZE; z += 8)
   {
@@ -214,8 +284,7 @@ void MazeGenerator::addCorridors(int chunkX, int chunkZ)
 
       if (isValidCell(worldX, worldZ))
       {
-        int index = getIndex(worldX, worldZ);
-        cells[index].type = CellType::FLOOR;
+        setCellType(worldX, worldZ, CellType::FLOOR);
       }
     }
   }
@@ -230,68 +299,92 @@ void MazeGenerator::addCorridors(int chunkX, int chunkZ)
 
       if (isValidCell(worldX, worldZ))
       {
-        int index = getIndex(worldX, worldZ);
-        cells[index].type = CellType::FLOOR;
+        setCellType(worldX, worldZ, CellType::FLOOR);
       }
     }
   }
 }
 
-void MazeGenerator::carvePath(int x, int z)
+void MazeGenerator::carvePath(int startX, int startZ)
 {
-  if (!isValidCell(x, z))
+  if (!isValidCell(startX, startZ))
     return;
 
-  int index = getIndex(x, z);
-  cells[index].type = CellType::FLOOR;
-  cells[index].visited = true;
-
-  auto neighbors = getNeighbors(x, z);
-  std::shuffle(neighbors.begin(), neighbors.end(), rng);
-
-  for (const auto &neighbor : neighbors)
+  // Depth-first carve with an explicit stack, so maze size is bounded by memory rather than
+  // the call stack. Each frame makes the same RNG draw the recursive version made on entering
+  // the cell (one shuffle of its in-bounds neighbours), so output is identical for a seed.
+  struct Frame
+  {
+    int x, z;
+    uint8_t directions[4]; // indices into STEP_X/STEP_Z, shuffled
+    uint8_t count;
+    uint8_t next;
+  };
+  static const int STEP_X[4] = {-2, 2, 0, 0};
+  static const int STEP_Z[4] = {0, 0, -2, 2};
+
+  auto enter = [this](int x, int z)
   {
-    int nx = neighbor.x;
-    int nz = neighbor.y;
+    setCellType(x, z, CellType::FLOOR);
+    visitedBits.set(x, z);
+
+    // Same neighbour order as before: -X, +X, -Z, +Z (two cells away, in bounds)
+    Frame frame{x, z, {}, 0, 0};
+    if (x >= 2)
+      frame.directions[frame.count++] = 0;
+    if (x < width - 2)
+      frame.directions[frame.count++] = 1;
+    if (z >= 2)
+      frame.directions[frame.count++] = 2;
+    if (z < height - 2)
+      frame.directions[frame.count++] = 3;
+    std::shuffle(frame.directions, frame.directions + frame.count, rng);
+    return frame;
+  };
+
+  std::vector<Frame> stack;
+  stack.push_back(enter(startX, startZ));
+  while (!stack.empty())
+  {
+    Frame &top = stack.back();
+    if (top.next == top.count)
+    {
+      stack.pop_back();
+      continue;
+    }
 
-    if (isValidCell(nx, nz) && !cells[getIndex(nx, nz)].visited)
+    int direction = top.directions[top.next++];
+    int nx = top.x + STEP_X[direction];
+    int nz = top.z + STEP_Z[direction];
+    if (isValidCell(nx, nz) && !visitedBits.test(nx, nz))
     {
       // Carve path between current cell and neighbor
-      int betweenX = x + (nx - x) / 2;
-      int betweenZ = z + (nz - z) / 2;
-
+      int betweenX = top.x + STEP_X[direction] / 2;
+      int betweenZ = top.z + STEP_Z[direction] / 2;
       if (isValidCell(betweenX, betweenZ))
       {
-        cells[getIndex(betweenX, betweenZ)].type = CellType::FLOOR;
+        setCellType(betweenX, betweenZ, CellType::FLOOR);
       }
 
-      carvePath(nx, nz);
+      stack.push_back(enter(nx, nz)); // may reallocate; `top` is not used past this point
     }
   }
 }
 
-std::vector<glm::ivec2> MazeGenerator::getNeighbors(int x, int z)
-{
-  std::vector<glm::ivec2> neighbors;
-
-  // Get neighbors 2 cells away (for maze generation)
-  if (x >= 2)
-    neighbors.push_back({x - 2, z});
-  if (x < width - 2)
-    neighbors.push_back({x + 2, z});
-  if (z >= 2)
-    neighbors.push_back({x, z - 2});
-  if (z < height - 2)
-    neighbors.push_back({x, z + 2});
-
-  return neighbors;
-}
-
 CellType MazeGenerator::getCellType(int x, int z) const
 {
   if (!isValidCell(x, z))
     return CellType::WALL;
-  return cells[getIndex(x, z)].type;
+  if (mazeFile)
+    decodeRegion(x, z, 1, 1);
+  return static_cast<CellType>(typeBits[0].test(x, z) | (typeBits[1].test(x, z) << 1));
+}
+
+void MazeGenerator::setCellType(int x, int z, CellType type)
+{
+  int bits = static_cast<int>(type);
+  typeBits[0].assign(x, z, bits & 1);
+  typeBits[1].assign(x, z, bits & 2);
 }
 
 bool MazeGenerator::isWall(int x, int z) const
@@ -301,12 +394,17 @@ bool MazeGenerator::isWall(int x, int z) const
   {
     return true;
   }
-  return getCellType(x, z) == CellType::WALL;
+  if (mazeFile)
+    decodeRegion(x, z, 1, 1);
+  // WALL is type 0, so a wall has neither type bit set
+  return !typeBits[0].test(x, z) && !typeBits[1].test(x, z);
 }
 
 bool MazeGenerator::isFloor(int x, int z) const
 {
-  return getCellType(x, z) == CellType::FLOOR;
+  if (mazeFile && isValidCell(x, z))
+    decodeRegion(x, z, 1, 1);
+  return isValidCell(x, z) && typeBits[0].test(x, z) && !typeBits[1].test(x, z);
 }
 
 bool MazeGenerator::isValidCell(int x, int z) const
@@ -314,40 +412,161 @@ bool MazeGenerator::isValidCell(int x, int z) const
   return x >= 0 && x < width && z >= 0 && z < height;
 }
 
-int MazeGenerator::getIndex(int x, int z) const
+size_t MazeGenerator::getMemoryUsage() const
 {
-  return z * width + x;
+  return typeBits[0].memoryBytes() + typeBits[1].memoryBytes() + visitedBits.memoryBytes();
 }
 
-std::vector<MazeCell> MazeGenerator::getChunk(int chunkX, int chunkZ) const
+void MazeGenerator::releaseCells(BitGrid &typeLow, BitGrid &typeHigh, BitGrid &visited)
 {
-  std::vector<MazeCell> chunk;
+  decodeAll();
+  typeLow = std::move(typeBits[0]);
+  typeHigh = std::move(typeBits[1]);
+  visited = std::move(visitedBits);
+  typeBits[0] = typeBits[1] = visitedBits = BitGrid();
+  width = height = 0;
+}
 
-  int startX = chunkX * CHUNK_SIZE;
-  int startZ = chunkZ * CHUNK_SIZE;
+MazeCell MazeGenerator::getCell(int x, int z) const
+{
+  MazeCell cell;
+  cell.type = getCellType(x, z);
+  cell.position = cellPosition(x, z);
+  cell.visited = isValidCell(x, z) && visitedBits.test(x, z);
+  return cell;
+}
 
-  for (int z = 0; z < CHUNK_SIZE; ++z)
+std::vector<MazeCell> MazeGenerator::getCells() const
+{
+  decodeAll();
+  std::vector<MazeCell> cells;
+  cells.reserve(static_cast<size_t>(width) * height);
+  for (int z = 0; z < height; ++z)
+    for (int x = 0; x < width; ++x)
+      cells.push_back(getCell(x, z));
+  return cells;
+}
+
+MazeGridView MazeGenerator::chunkView(int chunkX, int chunkZ) const
+{
+  decodeRegion(chunkX * CHUNK_SIZE, chunkZ * CHUNK_SIZE, CHUNK_SIZE, CHUNK_SIZE);
+  return gridView().subView(chunkX * CHUNK_SIZE, chunkZ * CHUNK_SIZE, CHUNK_SIZE, CHUNK_SIZE);
+}
+
+std::vector<MazeCell> MazeGenerator::getChunk(int chunkX, int chunkZ) const
+{
+  MazeGridView chunk = chunkView(chunkX, chunkZ);
+  std::vector<MazeCell> cells;
+  cells.reserve(static_cast<size_t>(std::max(chunk.getWidth(), 0)) * std::max(chunk.getHeight(), 0));
+
+  for (int z = 0; z < chunk.getHeight(); ++z)
   {
-    for (int x = 0; x < CHUNK_SIZE; ++x)
+    for (int x = 0; x < chunk.getWidth(); ++x)
     {
-      int worldX = startX + x;
-      int worldZ = startZ + z;
+      cells.push_back(chunk.getCell(x, z));
+    }
+  }
 
-      if (isValidCell(worldX, worldZ))
+  return cells;
+}
+
+bool MazeGenerator::save(const std::string &path) const
+{
+  decodeAll();
+  return MazeFile::write(path, seed, CHUNK_SIZE, typeBits[0], typeBits[1], visitedBits);
+}
+
+bool MazeGenerator::load(const std::string &path)
+{
+  std::shared_ptr<const MazeFile> file = MazeFile::open(path);
+  if (!file)
+    return false;
+
+  // Only allocate here; cells are decoded from the mapping as they are first read
+  const MazeFileFormat::Header &header = file->getHeader();
+  width = header.width;
+  height = header.height;
+  seed = header.seed;
+  rng.seed(seed);
+  typeBits[0] = BitGrid(width, height);
+  typeBits[1] = BitGrid(width, height);
+  visitedBits = BitGrid(width, height);
+
+  mazeFile = file;
+  decodedChunks = BitGrid(header.chunksX, header.chunksZ);
+  chunksPending = header.chunksX * header.chunksZ;
+  return true;
+}
+
+void MazeGenerator::decodeRegion(int x, int z, int w, int h) const
+{
+  int x0 = std::max(x, 0), z0 = std::max(z, 0);
+  int x1 = std::min(x + w, width), z1 = std::min(z + h, height);
+  if (!mazeFile || x0 >= x1 || z0 >= z1)
+    return;
+
+  const int fileChunkSize = mazeFile->getHeader().chunkSize;
+  for (int chunkZ = z0 / fileChunkSize; chunkZ <= (z1 - 1) / fileChunkSize; ++chunkZ)
+  {
+    for (int chunkX = x0 / fileChunkSize; chunkX <= (x1 - 1) / fileChunkSize; ++chunkX)
+    {
+      if (decodedChunks.test(chunkX, chunkZ))
+        continue;
+      if (!mazeFile->decodeChunk(chunkX, chunkZ, typeBits[0], typeBits[1], visitedBits))
       {
-        chunk.push_back(cells[getIndex(worldX, worldZ)]);
+        // The decoder may have stored part of the chunk before finding the damage; wall it all
+        // (WALL is zero in both type bits)
+        int cellX0 = chunkX * fileChunkSize, cellX1 = std::min(cellX0 + fileChunkSize, width);
+        for (int cellZ = chunkZ * fileChunkSize; cellZ < std::min((chunkZ + 1) * fileChunkSize, height); ++cellZ)
+        {
+          typeBits[0].assignSpan(cellZ, cellX0, cellX1, false);
+          typeBits[1].assignSpan(cellZ, cellX0, cellX1, false);
+          visitedBits.assignSpan(cellZ, cellX0, cellX1, false);
+        }
+        std::cout << "Corrupt maze file chunk (" << chunkX << ", " << chunkZ << "), left as walls" << std::endl;
       }
+      decodedChunks.set(chunkX, chunkZ);
+      chunksPending--;
     }
   }
 
-  return chunk;
+  if (chunksPending == 0)
+  {
+    mazeFile.reset();
+    decodedChunks = BitGrid();
+  }
+}
+
+void MazeGenerator::discardFile()
+{
+  mazeFile.reset();
+  decodedChunks = BitGrid();
+  chunksPending = 0;
 }
 
-// Exact translations of Python functions
+MazeCell MazeGridView::getCell(int x, int z) const
+{
+  MazeCell cell;
+  cell.type = getCellType(x, z);
+  cell.position = MazeGenerator::cellPosition(originX + x, originZ + z);
+  cell.visited = contains(x, z) && visited->test(originX + x, originZ + z);
+  return cell;
+}
+
+MazeGridView MazeGridView::subView(int x, int z, int subWidth, int subHeight) const
+{
+  int x0 = std::max(x, 0), z0 = std::max(z, 0);
+  int x1 = std::min(x + subWidth, width), z1 = std::min(z + subHeight, height);
+  return MazeGridView(*typeLow, *typeHigh, *visited, originX + x0, originZ + z0, std::max(x1 - x0, 0), std::max(z1 - z0, 0));
+}
+
+// Exact translations of Python functions. Rooms are placed first (every RNG draw in the original
+// order) and written afterwards by stampRooms(), which gives the same cells since writing draws nothing.
 void MazeGenerator::generateRooms(int numRooms, int widthMin, int widthMax, int heightMin, int heightMax)
 {
   std::uniform_int_distribution<int> widthDist(widthMin, widthMax);
   std::uniform_int_distribution<int> heightDist(heightMin, heightMax);
+  std::vector<RoomStamp> rooms;
 
   for (int i = 0; i < numRooms; ++i)
   {
@@ -360,19 +579,14 @@ void MazeGenerator::generateRooms(int numRooms, int widthMin, int widthMax, int
     int x = std::uniform_int_distribution<int>(0, width - roomWidth)(rng);
     int z = std::uniform_int_distribution<int>(0, height - roomHeight)(rng);
 
-    // Carve out room (exact Python logic)
+    // Carve out room (exact Python logic): one span per row
+    RoomStamp room;
     for (int row = z; row < z + roomHeight; ++row)
-    {
-      for (int col = x; col < x + roomWidth; ++col)
-      {
-        if (isValidCell(col, row))
-        {
-          cells[getIndex(col, row)].visited = true;
-          cells[getIndex(col, row)].type = CellType::FLOOR;
-        }
-      }
-    }
+      room.spans.push_back({row, x, x + roomWidth});
+    rooms.push_back(std::move(room));
   }
+
+  stampRooms(rooms);
 }
 
 void MazeGenerator::generatePillarRooms(int numRooms, int widthMin, int widthMax,
@@ -382,6 +596,7 @@ void MazeGenerator::generatePillarRooms(int numRooms, int widthMin, int widthMax
   std::uniform_int_distribution<int> widthDist(widthMin, widthMax);
   std::uniform_int_distribution<int> heightDist(heightMin, heightMax);
   std::uniform_int_distribution<int> spacingDist(spacingMin, spacingMax);
+  std::vector<RoomStamp> rooms;
 
   for (int i = 0; i < numRooms; ++i)
   {
@@ -394,39 +609,24 @@ void MazeGenerator::generatePillarRooms(int numRooms, int widthMin, int widthMax
     int x = std::uniform_int_distribution<int>(0, width - roomWidth)(rng);
     int z = std::uniform_int_distribution<int>(0, height - roomHeight)(rng);
 
-    // First carve out the room (exact Python logic)
+    // First carve out the room, then add pillars (exact Python logic)
+    RoomStamp room;
     for (int row = z; row < z + roomHeight; ++row)
-    {
-      for (int col = x; col < x + roomWidth; ++col)
-      {
-        if (isValidCell(col, row))
-        {
-          cells[getIndex(col, row)].visited = true;
-          cells[getIndex(col, row)].type = CellType::FLOOR;
-        }
-      }
-    }
-
-    // Add pillars (exact Python logic)
-    int pillarSpacing = spacingDist(rng);
-    for (int row = z; row < z + roomHeight; row += pillarSpacing)
-    {
-      for (int col = x; col < x + roomWidth; col += pillarSpacing)
-      {
-        if (isValidCell(col, row))
-        {
-          cells[getIndex(col, row)].visited = false;
-          cells[getIndex(col, row)].type = CellType::WALL;
-        }
-      }
-    }
+      room.spans.push_back({row, x, x + roomWidth});
+    room.pillarSpacing = spacingDist(rng);
+    room.pillarX = x;
+    room.pillarZ = z;
+    rooms.push_back(std::move(room));
   }
+
+  stampRooms(rooms);
 }
 
 void MazeGenerator::generateCustomRooms(int numRooms, int minSides, int maxSides, int minRadius, int maxRadius)
 {
   std::uniform_int_distribution<int> sidesDist(minSides, maxSides);
   std::uniform_int_distribution<int> radiusDist(minRadius, maxRadius);
+  std::vector<RoomStamp> rooms;
 
   for (int i = 0; i < numRooms; ++i)
   {
@@ -450,51 +650,89 @@ void MazeGenerator::generateCustomRooms(int numRooms, int minSides, int maxSides
       vertices.push_back({vertexX, vertexZ});
     }
 
-    // Carve out the custom-shaped room (exact Python logic)
+    // Carve out the custom-shaped room, clipped to its bounding square
+    RoomStamp room;
     for (int row = z - roomRadius; row <= z + roomRadius; ++row)
-    {
-      for (int col = x - roomRadius; col <= x + roomRadius; ++col)
-      {
-        if (isValidCell(col, row) && isInsideCustomRoom(col, row, vertices))
-        {
-          cells[getIndex(col, row)].visited = true;
-          cells[getIndex(col, row)].type = CellType::FLOOR;
-        }
-      }
-    }
+      addPolygonSpans(room, row, x - roomRadius, x + roomRadius + 1, vertices);
+    rooms.push_back(std::move(room));
   }
+
+  stampRooms(rooms);
 }
 
-// Exact Python point-in-polygon algorithm
-bool MazeGenerator::isInsideCustomRoom(int x, int z, const std::vector<glm::ivec2> &vertices)
+// Scanline form of the Python point-in-polygon test: a cell (x, row) is inside when an odd
+// number of edges crossing the row have x < threshold, with the same truncating integer
+// threshold per edge. Sorting the thresholds turns the parity into spans, so each row costs
+// O(vertices log vertices) instead of O(vertices) per cell.
+void MazeGenerator::addPolygonSpans(RoomStamp &room, int row, int minX, int maxX, const std::vector<glm::ivec2> &vertices)
 {
   int numVertices = vertices.size();
-  bool inside = false;
+  std::vector<int> sorted;
+  sorted.reserve(numVertices);
 
   for (int i = 0; i < numVertices; ++i)
   {
     int j = (i + 1) % numVertices;
+    if ((vertices[i].y > row) == (vertices[j].y > row))
+      continue;
 
-    glm::ivec2 leftVertex, rightVertex;
-    if (vertices[i].x < vertices[j].x)
-    {
-      leftVertex = vertices[i];
-      rightVertex = vertices[j];
-    }
-    else
-    {
-      leftVertex = vertices[j];
-      rightVertex = vertices[i];
-    }
+    const glm::ivec2 &leftVertex = vertices[i].x < vertices[j].x ? vertices[i] : vertices[j];
+    const glm::ivec2 &rightVertex = vertices[i].x < vertices[j].x ? vertices[j] : vertices[i];
+    sorted.push_back((rightVertex.x - leftVertex.x) * (row - leftVertex.y) / (rightVertex.y - leftVertex.y) + leftVertex.x);
+  }
+  std::sort(sorted.begin(), sorted.end());
+  int count = static_cast<int>(sorted.size());
 
-    if ((vertices[i].y > z) != (vertices[j].y > z) &&
-        x < (rightVertex.x - leftVertex.x) * (z - leftVertex.y) / (rightVertex.y - leftVertex.y) + leftVertex.x)
+  // Between the m-th and (m + 1)-th smallest thresholds, count - m edges are still to the right
+  for (int m = 0; m <= count; ++m)
+  {
+    if (((count - m) & 1) == 0)
+      continue;
+    int spanBegin = std::max(m == 0 ? minX : sorted[m - 1], minX);
+    int spanEnd = std::min(m == count ? maxX : sorted[m], maxX);
+    if (spanBegin < spanEnd)
+      room.spans.push_back({row, spanBegin, spanEnd});
+  }
+}
+
+void MazeGenerator::fillSpan(int z, int x0, int x1, CellType type, bool visited)
+{
+  if (z < 0 || z >= height)
+    return;
+  x0 = std::max(x0, 0);
+  x1 = std::min(x1, width);
+
+  int bits = static_cast<int>(type);
+  typeBits[0].assignSpan(z, x0, x1, bits & 1);
+  typeBits[1].assignSpan(z, x0, x1, bits & 2);
+  visitedBits.assignSpan(z, x0, x1, visited);
+}
+
+void MazeGenerator::stampRooms(const std::vector<RoomStamp> &rooms)
+{
+  // Rooms in placement order, so where rooms overlap the later one wins exactly as before.
+  // A few dozen rooms take microseconds to stamp, far less than starting threads would.
+  for (const RoomStamp &room : rooms)
+  {
+    for (const RoomSpan &span : room.spans)
+      fillSpan(span.z, span.x0, span.x1, CellType::FLOOR, true);
+
+    if (room.pillarSpacing <= 0 || room.spans.empty())
+      continue;
+    int roomEndZ = room.spans.back().z + 1;
+    int roomEndX = room.spans.front().x1;
+    for (int row = room.pillarZ; row < roomEndZ; row += room.pillarSpacing)
     {
-      inside = !inside;
+      for (int col = room.pillarX; col < roomEndX; col += room.pillarSpacing)
+      {
+        if (isValidCell(col, row))
+        {
+          visitedBits.reset(col, row);
+          setCellType(col, row, CellType::WALL);
+        }
+      }
     }
   }
-
-  return inside;
 }
 
 void MazeGenerator::generateBackroomCorridors()
@@ -515,8 +753,8 @@ void MazeGenerator::generateBackroomCorridors()
         {
           if (isValidCell(x, z + w))
           {
-            cells[getIndex(x, z + w)].visited = true;
-            cells[getIndex(x, z + w)].type = CellType::FLOOR;
+            visitedBits.set(x, z + w);
+            setCellType(x, z + w, CellType::FLOOR);
           }
         }
       }
@@ -535,8 +773,8 @@ void MazeGenerator::generateBackroomCorridors()
         {
           if (isValidCell(x + w, z))
           {
-            cells[getIndex(x + w, z)].visited = true;
-            cells[getIndex(x + w, z)].type = CellType::FLOOR;
+            visitedBits.set(x + w, z);
+            setCellType(x + w, z, CellType::FLOOR);
           }
         }
       }
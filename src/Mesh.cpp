@@ -31,7 +31,7 @@ void Mesh::Draw(Shader &shader) const
     else if (name == "texture_height")
       number = std::to_string(heightNr++);
 
-    glUniform1i(glGetUniformLocation(shader.ID, (name + number).c_str()), i);
+    shader.setInt(name + number, i);
     glBindTexture(GL_TEXTURE_2D, textures[i].id);
   }
 
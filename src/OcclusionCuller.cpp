@@ -1,127 +1,534 @@
 #include "OcclusionCuller.h"
-#include "MazeGenerator.h"
-#include <glad/glad.h>
+#include "ChunkedWorld.h"
+#include "MazeGeometry.h"
 #include <algorithm>
-#include <iostream>
+#include <chrono>
+#include <cmath>
 
-OcclusionCuller::OcclusionCuller()
-    : nextQueryID(1), frameCount(0), occludedCells(0)
+// Pixels shaded together; x86-64 always has SSE
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define OCCLUSION_SIMD_WIDTH 4
+#else
+#define OCCLUSION_SIMD_WIDTH 1
+#endif
+
+namespace
 {
+  const float PI = 3.14159265358979323846f;
+  // Intervals closer than this are joined, so walls touching only at a corner leave no crack
+  const float MERGE_EPSILON = 1e-5f;
+
+  float wrapAngle(float angle)
+  {
+    if (angle > PI)
+      return angle - 2.0f * PI;
+    if (angle <= -PI)
+      return angle + 2.0f * PI;
+    return angle;
+  }
+
+  // Angles under which the camera at (eyeX, eyeZ) sees cell (x, z), all in cell units, as one
+  // or (when it straddles the -pi/pi seam) two intervals. The eye is never inside the cell, so
+  // the extent is always narrower than pi.
+  int cellExtent(float eyeX, float eyeZ, int x, int z, std::pair<float, float> extent[2])
+  {
+    float center = std::atan2(z - eyeZ, x - eyeX);
+    float low = 0.0f, high = 0.0f;
+    for (int corner = 0; corner < 4; ++corner)
+    {
+      float cornerX = x + ((corner & 1) ? 0.5f : -0.5f);
+      float cornerZ = z + ((corner & 2) ? 0.5f : -0.5f);
+      float delta = wrapAngle(std::atan2(cornerZ - eyeZ, cornerX - eyeX) - center);
+      low = std::min(low, delta);
+      high = std::max(high, delta);
+    }
+
+    float start = center + low, end = center + high;
+    if (start < -PI)
+    {
+      extent[0] = {start + 2.0f * PI, PI};
+      extent[1] = {-PI, end};
+      return 2;
+    }
+    if (end > PI)
+    {
+      extent[0] = {start, PI};
+      extent[1] = {-PI, end - 2.0f * PI};
+      return 2;
+    }
+    extent[0] = {start, end};
+    return 1;
+  }
 }
 
-OcclusionCuller::~OcclusionCuller()
+template <typename Maze>
+void OcclusionCuller::update(const Maze &maze, const glm::vec3 &cameraPos, int radius)
 {
-  cleanup();
+  using namespace MazeGeometry;
+
+  // Eye in cell units (cell c covers [c - 0.5, c + 0.5]), kept just inside its own cell so no
+  // other cell ever touches it
+  const glm::ivec2 cell = cameraCell(cameraPos);
+  const int cameraX = cell.x, cameraZ = cell.y;
+  float eyeX = std::clamp(cameraPos.x / CELL_SIZE, cameraX - 0.499f, cameraX + 0.499f);
+  float eyeZ = std::clamp(cameraPos.z / CELL_SIZE, cameraZ - 0.499f, cameraZ + 0.499f);
+
+  const int side = 2 * radius + 1;
+  originX = cameraX - radius;
+  originZ = cameraZ - radius;
+  if (visibility.getWidth() != side)
+    visibility = BitGrid(side, side);
+  visibility.fill(false);
+  cellsVisible = 0;
+  cellsOccluded = 0;
+  hidden.clear();
+
+  valid = !maze.isWall(cameraX, cameraZ);
+  if (!valid)
+    return;
+  visibility.set(radius, radius);
+  cellsVisible = 1;
+
+  bool sweeping = true;
+  auto visitCell = [&](int dx, int dz)
+  {
+    int x = cameraX + dx, z = cameraZ + dz;
+    bool wall = maze.isWall(x, z);
+
+    // The eight neighbours are always drawn; beyond them a cell needs some uncovered angle
+    bool visible = std::abs(dx) <= 1 && std::abs(dz) <= 1;
+    Interval extent[2];
+    int parts = 0;
+    if (sweeping)
+    {
+      parts = cellExtent(eyeX, eyeZ, x, z, extent);
+      for (int i = 0; i < parts && !visible; ++i)
+        visible = !isHidden(extent[i]);
+    }
+
+    if (visible)
+    {
+      if (wall)
+        ringHidden.insert(ringHidden.end(), extent, extent + parts);
+      else
+      {
+        visibility.set(dx + radius, dz + radius);
+        cellsVisible++;
+      }
+    }
+    else if (!wall)
+    {
+      cellsOccluded++;
+    }
+  };
+
+  for (int ring = 1; ring <= 2 * radius; ++ring)
+  {
+    for (int dx = -std::min(ring, radius); dx <= std::min(ring, radius); ++dx)
+    {
+      int dz = ring - std::abs(dx);
+      if (dz > radius)
+        continue;
+      visitCell(dx, dz);
+      if (dz != 0)
+        visitCell(dx, -dz);
+    }
+
+    // Once every direction is blocked the remaining rings are only counted
+    mergeRing();
+    sweeping = sweeping && !allHidden();
+  }
 }
 
-void OcclusionCuller::initialize()
+bool OcclusionCuller::isHidden(const Interval &interval) const
 {
-  // Check if occlusion queries are supported
-  if (!GLAD_GL_VERSION_1_5)
-  {
-    std::cout << "Warning: Occlusion queries not supported on this system" << std::endl;
+  // Last hidden interval starting at or before this one; it must reach past its end
+  auto after = std::upper_bound(hidden.begin(), hidden.end(), interval,
+                                [](const Interval &a, const Interval &b)
+                                { return a.first < b.first; });
+  return after != hidden.begin() && std::prev(after)->second >= interval.second;
+}
+
+void OcclusionCuller::mergeRing()
+{
+  if (ringHidden.empty())
     return;
-  }
 
-  // Pre-allocate query objects
-  queryPool.reserve(MAX_QUERIES);
+  hidden.insert(hidden.end(), ringHidden.begin(), ringHidden.end());
+  ringHidden.clear();
+  std::sort(hidden.begin(), hidden.end());
 
-  std::cout << "Occlusion culling initialized with " << MAX_QUERIES << " queries" << std::endl;
+  size_t merged = 0;
+  for (size_t i = 1; i < hidden.size(); ++i)
+  {
+    if (hidden[i].first <= hidden[merged].second + MERGE_EPSILON)
+      hidden[merged].second = std::max(hidden[merged].second, hidden[i].second);
+    else
+      hidden[++merged] = hidden[i];
+  }
+  hidden.resize(merged + 1);
 }
 
-void OcclusionCuller::beginFrame()
+bool OcclusionCuller::allHidden() const
 {
-  frameCount++;
-  occludedCells = 0;
-  // Simplified - no more query processing or cache management
+  return hidden.size() == 1 && hidden[0].first <= -PI + MERGE_EPSILON && hidden[0].second >= PI - MERGE_EPSILON;
 }
 
-bool OcclusionCuller::shouldRenderCell(const glm::ivec2 &cellPos, const glm::vec3 &worldPos,
-                                       const glm::vec3 &cameraPos, const MazeGenerator &maze)
+OcclusionCuller::~OcclusionCuller()
 {
-  // Much simpler and more reliable approach
-  float distance = glm::length(worldPos - cameraPos);
-
-  // Only consider occlusion culling for very close cells to minimize visual errors
-  if (distance > 8.0f || distance < 3.0f)
   {
-    return true; // Don't occlude if too far or too close
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
   }
+  wake.notify_all();
+  for (std::thread &worker : workers)
+    worker.join();
+}
 
-  // Very simple direction-based occlusion test
-  // Only cull if there's a wall directly between camera and target
-  glm::vec3 direction = glm::normalize(worldPos - cameraPos);
+void OcclusionCuller::addOccluder(const glm::vec3 &a, const glm::vec3 &b, const glm::vec3 &c, const glm::vec3 &d)
+{
+  occluders.push_back(a);
+  occluders.push_back(b);
+  occluders.push_back(c);
+  occluders.push_back(d);
+}
 
-  const float CELL_SIZE = 2.0f;
+template <typename Maze>
+void OcclusionCuller::addWallOccluders(const Maze &maze, const glm::vec3 &cameraPos, int radius)
+{
+  using namespace MazeGeometry;
+  const glm::ivec2 cell = cameraCell(cameraPos);
+  const int cameraX = cell.x, cameraZ = cell.y;
 
-  // Check just a few points along the line - be very conservative
-  int checkPoints = 3;
-  for (int i = 1; i <= checkPoints; i++)
+  // Faces of wall cells whose neighbour across the face is floor, for each of the four
+  // neighbours (-Z, +Z, -X, +X). Faces in one row share a plane, so runs of them merge.
+  const int neighbourX[4] = {0, 0, -1, 1};
+  const int neighbourZ[4] = {-1, 1, 0, 0};
+  for (int side = 0; side < 4; ++side)
   {
-    float t = (distance / checkPoints) * i;
-    glm::vec3 testPos = cameraPos + direction * t;
-
-    int gridX = static_cast<int>(testPos.x / CELL_SIZE);
-    int gridZ = static_cast<int>(testPos.z / CELL_SIZE);
+    bool alongX = side < 2;
+    float sign = (side & 1) ? 1.0f : -1.0f;
+    float camera = alongX ? cameraPos.z : cameraPos.x;
 
-    // If ANY point along the path is not a wall, don't occlude
-    if (!maze.isWall(gridX, gridZ))
+    for (int row = -radius; row <= radius; ++row)
     {
-      return true; // Clear path, render the cell
+      int line = (alongX ? cameraZ : cameraX) + row;
+      float plane = line * CELL_SIZE + sign * CELL_SIZE * 0.5f;
+      // Only faces the camera is in front of can hide anything
+      if ((camera - plane) * sign <= 0.0f)
+        continue;
+
+      int runStart = 0;
+      bool inRun = false;
+      for (int i = -radius; i <= radius + 1; ++i)
+      {
+        int along = (alongX ? cameraX : cameraZ) + i;
+        int x = alongX ? along : line, z = alongX ? line : along;
+        bool face = i <= radius && maze.isWall(x, z) && !maze.isWall(x + neighbourX[side], z + neighbourZ[side]);
+        if (face && !inRun)
+          runStart = along;
+        if (!face && inRun)
+        {
+          float start = runStart * CELL_SIZE - CELL_SIZE * 0.5f;
+          float end = along * CELL_SIZE - CELL_SIZE * 0.5f;
+          if (alongX)
+            addOccluder(glm::vec3(start, 0.0f, plane), glm::vec3(end, 0.0f, plane),
+                        glm::vec3(end, WALL_HEIGHT, plane), glm::vec3(start, WALL_HEIGHT, plane));
+          else
+            addOccluder(glm::vec3(plane, 0.0f, start), glm::vec3(plane, 0.0f, end),
+                        glm::vec3(plane, WALL_HEIGHT, end), glm::vec3(plane, WALL_HEIGHT, start));
+        }
+        inRun = face;
+      }
     }
   }
-
-  // Only occlude if ALL check points hit walls
-  occludedCells++;
-  return false;
 }
 
-void OcclusionCuller::endFrame()
+void OcclusionCuller::rasterize(const glm::mat4 &viewProjection)
 {
-  // Nothing specific needed here - queries are processed in beginFrame
+  auto begin = std::chrono::steady_clock::now();
+  rasterViewProjection = viewProjection;
+  polygons.clear();
+  for (std::vector<uint32_t> &bin : tileBins)
+    bin.clear();
+  for (int level = 0; level < DEPTH_LEVELS; ++level)
+    depthLevels[level].resize(static_cast<size_t>(DEPTH_WIDTH >> level) * (DEPTH_HEIGHT >> level));
+
+  // Clip each quad against the near plane (z >= -w in clip space)
+  for (size_t quad = 0; quad + 3 < occluders.size(); quad += 4)
+  {
+    glm::vec4 clipped[5];
+    int count = 0;
+    for (int i = 0; i < 4; ++i)
+    {
+      glm::vec4 a = viewProjection * glm::vec4(occluders[quad + i], 1.0f);
+      glm::vec4 b = viewProjection * glm::vec4(occluders[quad + (i + 1) % 4], 1.0f);
+      float distanceA = a.z + a.w, distanceB = b.z + b.w;
+      if (distanceA >= 0.0f)
+        clipped[count++] = a;
+      if ((distanceA >= 0.0f) != (distanceB >= 0.0f))
+        clipped[count++] = a + (b - a) * (distanceA / (distanceA - distanceB));
+    }
+    if (count >= 3)
+      addPolygon(clipped, count);
+  }
+
+  for (uint32_t i = 0; i < polygons.size(); ++i)
+  {
+    const RasterPolygon &polygon = polygons[i];
+    for (int tileY = polygon.minY / TILE_SIZE; tileY <= polygon.maxY / TILE_SIZE; ++tileY)
+      for (int tileX = polygon.minX / TILE_SIZE; tileX <= polygon.maxX / TILE_SIZE; ++tileX)
+        tileBins[tileY * TILES_X + tileX].push_back(i);
+  }
+
+  // Helpers start on first use: one per hardware thread beyond the render loop's, up to a few
+  if (workers.empty())
+  {
+    int helpers = std::min(MAX_HELPER_THREADS, static_cast<int>(std::thread::hardware_concurrency()) - 1);
+    for (int i = 0; i < helpers; ++i)
+      workers.emplace_back(&OcclusionCuller::workerLoop, this);
+  }
+
+  nextTile = 0;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    workersBusy = static_cast<int>(workers.size());
+    rasterFrame++;
+  }
+  wake.notify_all();
+  rasterizeTiles();
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    finished.wait(lock, [this]
+                  { return workersBusy == 0; });
+  }
+
+  // Tiles reduce themselves down to one texel each; the last levels span tiles
+  const int TILE_LEVELS = 6; // log2(TILE_SIZE) + 1
+  for (int level = TILE_LEVELS; level < DEPTH_LEVELS; ++level)
+  {
+    int width = DEPTH_WIDTH >> level, height = DEPTH_HEIGHT >> level;
+    const std::vector<float> &below = depthLevels[level - 1];
+    for (int y = 0; y < height; ++y)
+      for (int x = 0; x < width; ++x)
+      {
+        size_t index = static_cast<size_t>(y * 2) * (width * 2) + x * 2;
+        depthLevels[level][static_cast<size_t>(y) * width + x] =
+            std::max(std::max(below[index], below[index + 1]),
+                     std::max(below[index + width * 2], below[index + width * 2 + 1]));
+      }
+  }
+
+  depthValid = true;
+  rasterMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
 }
 
-void OcclusionCuller::cleanup()
+void OcclusionCuller::addPolygon(const glm::vec4 *clip, int count)
 {
-  // Simple cleanup
-  queryPool.clear();
-  activeQueries.clear();
-  visibilityCache.clear();
+  // To pixels (y up, like NDC) and depth in [0, 1]
+  float x[MAX_POLYGON_EDGES], y[MAX_POLYGON_EDGES], z[MAX_POLYGON_EDGES];
+  for (int i = 0; i < count; ++i)
+  {
+    float inverseW = 1.0f / clip[i].w;
+    x[i] = (clip[i].x * inverseW * 0.5f + 0.5f) * DEPTH_WIDTH;
+    y[i] = (clip[i].y * inverseW * 0.5f + 0.5f) * DEPTH_HEIGHT;
+    z[i] = clip[i].z * inverseW * 0.5f + 0.5f;
+  }
+
+  // The depth plane comes from the largest triangle of the fan, which also gives the winding
+  float area = 0.0f;
+  int planeCorner = 1;
+  for (int i = 1; i + 1 < count; ++i)
+  {
+    float fanArea = (x[i] - x[0]) * (y[i + 1] - y[0]) - (x[i + 1] - x[0]) * (y[i] - y[0]);
+    if (std::abs(fanArea) > std::abs(area))
+      area = fanArea, planeCorner = i;
+  }
+  if (std::abs(area) < 1e-6f)
+    return;
+  if (area < 0.0f)
+  {
+    std::reverse(x + 1, x + count), std::reverse(y + 1, y + count), std::reverse(z + 1, z + count);
+    planeCorner = count - 1 - planeCorner;
+    area = -area;
+  }
+
+  RasterPolygon polygon;
+  polygon.minX = std::max(0, static_cast<int>(std::floor(*std::min_element(x, x + count))));
+  polygon.minY = std::max(0, static_cast<int>(std::floor(*std::min_element(y, y + count))));
+  polygon.maxX = std::min(DEPTH_WIDTH - 1, static_cast<int>(std::ceil(*std::max_element(x, x + count))));
+  polygon.maxY = std::min(DEPTH_HEIGHT - 1, static_cast<int>(std::ceil(*std::max_element(y, y + count))));
+  if (polygon.minX > polygon.maxX || polygon.minY > polygon.maxY)
+    return;
+
+  // Moving each edge half a pixel inwards (the edge's value at the pixel's worst corner) means a
+  // pixel centre passes only when the whole pixel is covered
+  for (int i = 0; i < MAX_POLYGON_EDGES; ++i)
+  {
+    if (i >= count)
+    {
+      polygon.edgeA[i] = polygon.edgeB[i] = polygon.edgeC[i] = 0.0f;
+      continue;
+    }
+    int j = (i + 1) % count;
+    polygon.edgeA[i] = y[i] - y[j];
+    polygon.edgeB[i] = x[j] - x[i];
+    polygon.edgeC[i] = x[i] * y[j] - y[i] * x[j] - 0.5f * (std::abs(polygon.edgeA[i]) + std::abs(polygon.edgeB[i]));
+  }
+
+  // Likewise depth is taken at the farthest corner of the pixel
+  int b = planeCorner, c = planeCorner + 1;
+  polygon.depthA = ((z[b] - z[0]) * (y[c] - y[0]) - (z[c] - z[0]) * (y[b] - y[0])) / area;
+  polygon.depthB = ((x[b] - x[0]) * (z[c] - z[0]) - (x[c] - x[0]) * (z[b] - z[0])) / area;
+  polygon.depthC = z[0] - polygon.depthA * x[0] - polygon.depthB * y[0] +
+                   0.5f * (std::abs(polygon.depthA) + std::abs(polygon.depthB));
+  polygons.push_back(polygon);
 }
 
-int OcclusionCuller::getCellKey(const glm::ivec2 &cellPos) const
+void OcclusionCuller::workerLoop()
 {
-  // Simple hash function for 2D coordinates
-  return cellPos.x * 73856093 + cellPos.y * 19349663;
+  int frameDone = 0;
+  while (true)
+  {
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      wake.wait(lock, [&]
+                { return stopping || rasterFrame != frameDone; });
+      if (stopping)
+        return;
+      frameDone = rasterFrame;
+    }
+
+    rasterizeTiles();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (--workersBusy == 0)
+      finished.notify_one();
+  }
 }
 
-bool OcclusionCuller::isLikelyOccluded(const glm::vec3 &cellPos, const glm::vec3 &cameraPos,
-                                       const MazeGenerator &maze) const
+void OcclusionCuller::rasterizeTiles()
 {
-  // Removed complex ray-marching - this simple version handles it in shouldRenderCell
-  return false; // Not used anymore
+  int tile;
+  while ((tile = nextTile.fetch_add(1)) < TILES_X * TILES_Y)
+    rasterizeTile(tile);
 }
 
-void OcclusionCuller::renderOcclusionProxy(const glm::vec3 &position)
+void OcclusionCuller::rasterizeTile(int tile)
 {
-  // Simplified approach for now - just return without rendering
-  // In a full implementation, you'd render proper geometry using modern OpenGL
-  // with vertex buffers and shaders
+  const int tileX0 = (tile % TILES_X) * TILE_SIZE, tileY0 = (tile / TILES_X) * TILE_SIZE;
+  std::vector<float> &depth = depthLevels[0];
+  for (int y = tileY0; y < tileY0 + TILE_SIZE; ++y)
+    std::fill_n(depth.begin() + static_cast<size_t>(y) * DEPTH_WIDTH + tileX0, TILE_SIZE, 1.0f);
 
-  // For now, we'll rely on the heuristic-based occlusion testing
-  // which doesn't require rendering proxy geometry
-}
+  for (uint32_t index : tileBins[tile])
+  {
+    const RasterPolygon &t = polygons[index];
+    // Tiles are a multiple of the SIMD width wide, so aligned groups never leave the tile
+    int x0 = std::max(t.minX, tileX0) & ~(OCCLUSION_SIMD_WIDTH - 1);
+    int x1 = std::min(t.maxX, tileX0 + TILE_SIZE - 1);
+    int y0 = std::max(t.minY, tileY0), y1 = std::min(t.maxY, tileY0 + TILE_SIZE - 1);
 
-void OcclusionCuller::updateQueryResults()
-{
-  // Simplified version - no OpenGL queries for now
+    for (int y = y0; y <= y1; ++y)
+    {
+      float centerY = y + 0.5f;
+      float rowEdge[MAX_POLYGON_EDGES];
+      for (int i = 0; i < MAX_POLYGON_EDGES; ++i)
+        rowEdge[i] = t.edgeB[i] * centerY + t.edgeC[i];
+      float rowDepth = t.depthB * centerY + t.depthC;
+      float *out = depth.data() + static_cast<size_t>(y) * DEPTH_WIDTH;
+
+#if OCCLUSION_SIMD_WIDTH == 4
+      const __m128 zero = _mm_setzero_ps();
+      const __m128 step = _mm_set_ps(3.5f, 2.5f, 1.5f, 0.5f);
+      for (int x = x0; x <= x1; x += 4)
+      {
+        __m128 centerX = _mm_add_ps(_mm_set1_ps(static_cast<float>(x)), step);
+        __m128 inside = _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(t.edgeA[0]), centerX), _mm_set1_ps(rowEdge[0])), zero);
+        for (int i = 1; i < MAX_POLYGON_EDGES; ++i)
+          inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(t.edgeA[i]), centerX), _mm_set1_ps(rowEdge[i])), zero));
+        if (_mm_movemask_ps(inside) == 0)
+          continue;
+        __m128 z = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(t.depthA), centerX), _mm_set1_ps(rowDepth));
+        __m128 old = _mm_loadu_ps(out + x);
+        __m128 nearest = _mm_min_ps(old, z);
+        _mm_storeu_ps(out + x, _mm_or_ps(_mm_and_ps(inside, nearest), _mm_andnot_ps(inside, old)));
+      }
+#else
+      for (int x = x0; x <= x1; ++x)
+      {
+        float centerX = x + 0.5f;
+        bool inside = true;
+        for (int i = 0; i < MAX_POLYGON_EDGES; ++i)
+          inside = inside && t.edgeA[i] * centerX + rowEdge[i] >= 0.0f;
+        if (inside)
+          out[x] = std::min(out[x], t.depthA * centerX + rowDepth);
+      }
+#endif
+    }
+  }
+
+  // Reduce the tile down to a single texel
+  for (int level = 1, size = TILE_SIZE / 2; size >= 1; ++level, size /= 2)
+  {
+    int width = DEPTH_WIDTH >> level, belowWidth = width * 2;
+    int x0 = tileX0 >> level, y0 = tileY0 >> level;
+    const std::vector<float> &below = depthLevels[level - 1];
+    for (int y = y0; y < y0 + size; ++y)
+      for (int x = x0; x < x0 + size; ++x)
+      {
+        size_t index = static_cast<size_t>(y * 2) * belowWidth + x * 2;
+        depthLevels[level][static_cast<size_t>(y) * width + x] =
+            std::max(std::max(below[index], below[index + 1]),
+                     std::max(below[index + belowWidth], below[index + belowWidth + 1]));
+      }
+  }
 }
 
-void OcclusionCuller::cleanupOldQueries()
+bool OcclusionCuller::isAABBOccluded(const AABB &box) const
 {
-  // Simplified cleanup - just clear cache if it gets too large
-  if (visibilityCache.size() > MAX_QUERIES * 2)
+  if (!depthValid)
+    return false;
+
+  // Screen rectangle and nearest depth of the corners; a box's nearest point is always a corner
+  float minX = INFINITY, minY = INFINITY, maxX = -INFINITY, maxY = -INFINITY, nearest = INFINITY;
+  for (int corner = 0; corner < 8; ++corner)
   {
-    visibilityCache.clear();
+    glm::vec3 point((corner & 1) ? box.max.x : box.min.x, (corner & 2) ? box.max.y : box.min.y,
+                    (corner & 4) ? box.max.z : box.min.z);
+    glm::vec4 clip = rasterViewProjection * glm::vec4(point, 1.0f);
+    if (clip.z < -clip.w || clip.w <= 0.0f)
+      return false;
+    float inverseW = 1.0f / clip.w;
+    float x = (clip.x * inverseW * 0.5f + 0.5f) * DEPTH_WIDTH;
+    float y = (clip.y * inverseW * 0.5f + 0.5f) * DEPTH_HEIGHT;
+    minX = std::min(minX, x), maxX = std::max(maxX, x);
+    minY = std::min(minY, y), maxY = std::max(maxY, y);
+    nearest = std::min(nearest, clip.z * inverseW * 0.5f + 0.5f);
   }
-}
\ No newline at end of file
+
+  int x0 = std::max(0, static_cast<int>(std::floor(minX))), x1 = std::min(DEPTH_WIDTH - 1, static_cast<int>(std::floor(maxX)));
+  int y0 = std::max(0, static_cast<int>(std::floor(minY))), y1 = std::min(DEPTH_HEIGHT - 1, static_cast<int>(std::floor(maxY)));
+  if (x0 > x1 || y0 > y1)
+    return false;
+
+  // Coarsest level with at most 4x4 texels under the rectangle; all must be nearer than the box
+  int level = 0;
+  while (level < DEPTH_LEVELS - 1 && ((x1 >> level) - (x0 >> level) > 3 || (y1 >> level) - (y0 >> level) > 3))
+    level++;
+  int width = DEPTH_WIDTH >> level;
+  for (int y = y0 >> level; y <= y1 >> level; ++y)
+    for (int x = x0 >> level; x <= x1 >> level; ++x)
+    {
+      if (depthLevels[level][static_cast<size_t>(y) * width + x] >= nearest)
+        return false;
+    }
+  return true;
+}
+
+// The mazes the camera can look around in
+template void OcclusionCuller::update<MazeGenerator>(const MazeGenerator &, const glm::vec3 &, int);
+template void OcclusionCuller::update<ChunkedWorld>(const ChunkedWorld &, const glm::vec3 &, int);
+template void OcclusionCuller::addWallOccluders<MazeGenerator>(const MazeGenerator &, const glm::vec3 &, int);
+template void OcclusionCuller::addWallOccluders<ChunkedWorld>(const ChunkedWorld &, const glm::vec3 &, int);
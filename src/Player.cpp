@@ -1,4 +1,5 @@
 #include "Player.h"
+#include "ChunkedWorld.h"
 #include <algorithm>
 #include <iostream>
 #include <cmath>
@@ -29,7 +30,8 @@ Player::Player(Camera *cam, glm::vec3 startPos)
   }
 }
 
-void Player::Update(float deltaTime, const MazeGenerator &maze)
+template <typename Maze>
+void Player::Update(float deltaTime, const Maze &maze)
 {
   if (godMode)
   {
@@ -214,7 +216,8 @@ void Player::ToggleGodMode()
   }
 }
 
-bool Player::CheckCollision(const glm::vec3 &newPos, const MazeGenerator &maze)
+template <typename Maze>
+bool Player::CheckCollision(const glm::vec3 &newPos, const Maze &maze)
 {
   return CheckWallCollision(newPos, maze);
 }
@@ -224,7 +227,8 @@ glm::vec3 Player::GetCameraPosition() const
   return position + glm::vec3(0.0f, eyeHeight, 0.0f);
 }
 
-void Player::SetPosition(const glm::vec3 &newPos, const MazeGenerator &maze)
+template <typename Maze>
+void Player::SetPosition(const glm::vec3 &newPos, const Maze &maze)
 {
   if (!CheckCollision(newPos, maze))
   {
@@ -236,7 +240,8 @@ void Player::SetPosition(const glm::vec3 &newPos, const MazeGenerator &maze)
   }
 }
 
-bool Player::CheckWallCollision(const glm::vec3 &pos, const MazeGenerator &maze)
+template <typename Maze>
+bool Player::CheckWallCollision(const glm::vec3 &pos, const Maze &maze)
 {
   // Check collision with walls using player's radius
   // Test multiple points around the player's circular hitbox
@@ -264,14 +269,16 @@ bool Player::CheckWallCollision(const glm::vec3 &pos, const MazeGenerator &maze)
   return false; // No collision
 }
 
-bool Player::CheckGroundCollision(const glm::vec3 &pos, const MazeGenerator &maze)
+template <typename Maze>
+bool Player::CheckGroundCollision(const glm::vec3 &pos, const Maze &maze)
 {
   // Player is on ground if they're at or below floor level
   // and not inside a wall
   return pos.y <= FLOOR_HEIGHT && !CheckWallCollision(pos, maze);
 }
 
-glm::vec3 Player::ResolveCollision(const glm::vec3 &oldPos, const glm::vec3 &newPos, const MazeGenerator &maze)
+template <typename Maze>
+glm::vec3 Player::ResolveCollision(const glm::vec3 &oldPos, const glm::vec3 &newPos, const Maze &maze)
 {
   // If no collision, accept the new position
   if (!CheckCollision(newPos, maze))
@@ -325,3 +332,11 @@ void Player::HandleJump()
     isGrounded = false;
   }
 }
+
+// The mazes the player can walk in
+template void Player::Update<MazeGenerator>(float, const MazeGenerator &);
+template bool Player::CheckCollision<MazeGenerator>(const glm::vec3 &, const MazeGenerator &);
+template void Player::SetPosition<MazeGenerator>(const glm::vec3 &, const MazeGenerator &);
+template void Player::Update<ChunkedWorld>(float, const ChunkedWorld &);
+template bool Player::CheckCollision<ChunkedWorld>(const glm::vec3 &, const ChunkedWorld &);
+template void Player::SetPosition<ChunkedWorld>(const glm::vec3 &, const ChunkedWorld &);
@@ -0,0 +1,280 @@
+#include "PotentiallyVisibleSet.h"
+#include "MazeGenerator.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace
+{
+  using Clock = std::chrono::steady_clock;
+
+  double nowMs()
+  {
+    return std::chrono::duration<double, std::milli>(Clock::now().time_since_epoch()).count();
+  }
+
+  // The eight reflections of the first octant (directions with 0 <= dz <= dx); together they cover
+  // every direction, the shared diagonals and axes twice
+  const int OCTANTS[8][4] = {{1, 0, 0, 1}, {-1, 0, 0, 1}, {1, 0, 0, -1}, {-1, 0, 0, -1},
+                             {0, 1, 1, 0}, {0, -1, 1, 0}, {0, 1, -1, 0}, {0, -1, -1, 0}};
+
+  void writeVarint(std::vector<uint8_t> &out, uint32_t value)
+  {
+    while (value >= 0x80)
+    {
+      out.push_back(static_cast<uint8_t>(value | 0x80));
+      value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+  }
+
+  // Keeps the lines of `in` with slope * a + offset * b <= c
+  template <typename LineSet>
+  void clipLines(const LineSet &in, double a, double b, double c, LineSet &out)
+  {
+    out.clear();
+    for (size_t i = 0; i < in.size(); ++i)
+    {
+      const auto &p = in[i], &q = in[(i + 1) % in.size()];
+      double distanceP = p.slope * a + p.offset * b - c;
+      double distanceQ = q.slope * a + q.offset * b - c;
+      if (distanceP <= 0.0)
+        out.push_back(p);
+      if ((distanceP <= 0.0) != (distanceQ <= 0.0))
+      {
+        double t = distanceP / (distanceP - distanceQ);
+        out.push_back({p.slope + (q.slope - p.slope) * t, p.offset + (q.offset - p.offset) * t});
+      }
+    }
+  }
+
+  // Sets of lines with no area only graze wall corners or run along wall faces: a cell seen
+  // through them alone covers no pixels, and the per-eye sweep doesn't count it either. The
+  // threshold is far below anything a pixel could show.
+  template <typename LineSet>
+  bool hasArea(const LineSet &lines)
+  {
+    double twiceArea = 0.0;
+    for (size_t i = 0; i < lines.size(); ++i)
+    {
+      const auto &p = lines[i], &q = lines[(i + 1) % lines.size()];
+      twiceArea += p.slope * q.offset - q.slope * p.offset;
+    }
+    return std::abs(twiceArea) > 1e-12;
+  }
+
+  uint32_t readVarint(const uint8_t *&in)
+  {
+    uint32_t value = 0;
+    for (int shift = 0;; shift += 7)
+    {
+      uint8_t byte = *in++;
+      value |= static_cast<uint32_t>(byte & 0x7F) << shift;
+      if (!(byte & 0x80))
+        return value;
+    }
+  }
+}
+
+void PotentiallyVisibleSet::build(const MazeGenerator &maze, int radius, int threadCount)
+{
+  cancel();
+
+  width = maze.getWidth();
+  height = maze.getHeight();
+  this->radius = radius;
+  floorBits = BitGrid(width, height);
+  maze.forEachFloorCell(0, 0, width, height, [this](int x, int z)
+                        { floorBits.set(x, z); });
+
+  cellRuns.assign(static_cast<size_t>(width) * height, std::vector<uint8_t>());
+  runs.clear();
+  offsets.clear();
+  hasDecoded = false;
+  stopping = false;
+  ready = false;
+  rowsDone = 0;
+  nextRow = 0;
+
+  if (threadCount <= 0)
+    threadCount = std::max(1, static_cast<int>(std::thread::hardware_concurrency()) - 1);
+  threadCount = std::max(1, std::min(threadCount, height));
+
+  double startMs = nowMs();
+  workersRunning = threadCount;
+  for (int i = 0; i < threadCount; ++i)
+    workers.emplace_back(&PotentiallyVisibleSet::workerLoop, this, startMs);
+}
+
+void PotentiallyVisibleSet::cancel()
+{
+  stopping = true;
+  for (std::thread &worker : workers)
+    worker.join();
+  workers.clear();
+  ready = false;
+  hasDecoded = false;
+}
+
+float PotentiallyVisibleSet::getProgress() const
+{
+  return height > 0 ? static_cast<float>(rowsDone.load()) / height : 0.0f;
+}
+
+void PotentiallyVisibleSet::workerLoop(double startMs)
+{
+  // Rows are handed out one at a time so uneven rows (open halls cost more) balance out
+  std::vector<uint64_t> window;
+  std::vector<LineSet> lines;
+  int z;
+  while (!stopping && (z = nextRow.fetch_add(1)) < height)
+  {
+    for (int x = 0; x < width; ++x)
+    {
+      if (isOpen(x, z))
+        encodeCell(x, z, window, lines, cellRuns[static_cast<size_t>(z) * width + x]);
+    }
+    rowsDone++;
+  }
+
+  // The last worker out packs every cell's runs into one array and publishes the set
+  if (workersRunning.fetch_sub(1) != 1 || stopping)
+    return;
+
+  offsets.resize(cellRuns.size() + 1);
+  size_t total = 0;
+  for (size_t i = 0; i < cellRuns.size(); ++i)
+    total += cellRuns[i].size();
+  runs.reserve(total);
+  for (size_t i = 0; i < cellRuns.size(); ++i)
+  {
+    offsets[i] = static_cast<uint32_t>(runs.size());
+    runs.insert(runs.end(), cellRuns[i].begin(), cellRuns[i].end());
+  }
+  offsets.back() = static_cast<uint32_t>(runs.size());
+  std::vector<std::vector<uint8_t>>().swap(cellRuns);
+
+  buildMs = nowMs() - startMs;
+  ready.store(true, std::memory_order_release);
+}
+
+void PotentiallyVisibleSet::encodeCell(int x, int z, std::vector<uint64_t> &window, std::vector<LineSet> &lines,
+                                       std::vector<uint8_t> &out) const
+{
+  const int side = 2 * radius + 1;
+  window.assign((static_cast<size_t>(side) * side + 63) / 64, 0);
+
+  // Neighbours (diagonals too) are always drawn, as the camera may stand right next to them
+  for (int dz = -1; dz <= 1; ++dz)
+  {
+    for (int dx = -1; dx <= 1; ++dx)
+    {
+      if (isOpen(x + dx, z + dz))
+      {
+        size_t bit = static_cast<size_t>(dz + radius) * side + (dx + radius);
+        window[bit / 64] |= uint64_t(1) << (bit % 64);
+      }
+    }
+  }
+
+  // Lines through the source cell, [-0.5, 0.5]^2, with slopes in [0, 1] have offsets in [-1, 1].
+  // A line moves one cell per edge crossed, so a path is at most 2 * radius cells long; the
+  // last set is scratch for clipping.
+  lines.resize(2 * radius + 3);
+  lines[0].assign({{0.0, -1.5}, {1.0, -1.5}, {1.0, 1.5}, {0.0, 1.5}});
+  for (const auto &o : OCTANTS)
+    sweepLines(x, z, Octant{o[0], o[1], o[2], o[3]}, 0, 0, lines, 0, window);
+
+  // Alternating run lengths, starting with an invisible run (possibly empty)
+  size_t count = static_cast<size_t>(side) * side;
+  bool current = false;
+  uint32_t run = 0;
+  for (size_t bit = 0; bit < count; ++bit)
+  {
+    bool value = (window[bit / 64] >> (bit % 64)) & 1;
+    if (value != current)
+    {
+      writeVarint(out, run);
+      current = value;
+      run = 0;
+    }
+    run++;
+  }
+  writeVarint(out, run);
+  out.shrink_to_fit();
+}
+
+void PotentiallyVisibleSet::sweepLines(int x, int z, const Octant &octant, int u, int v, std::vector<LineSet> &lines,
+                                       size_t depth, std::vector<uint64_t> &window) const
+{
+  const int side = 2 * radius + 1;
+  LineSet &crossing = lines.back();
+  for (int step = 0; step < 2; ++step)
+  {
+    int nextU = u + (step == 0), nextV = v + (step == 1);
+    if (nextU > radius || nextV > radius)
+      continue;
+    int dx = nextU * octant.xu + nextV * octant.xv, dz = nextU * octant.zu + nextV * octant.zv;
+    if (!isOpen(x + dx, z + dz))
+      continue;
+
+    // The lines that also cross the edge into the next cell: the one at u + 0.5 spanning
+    // [v - 0.5, v + 0.5], or the one at v + 0.5 spanning [u - 0.5, u + 0.5]
+    LineSet &next = lines[depth + 1];
+    if (step == 0)
+    {
+      clipLines(lines[depth], u + 0.5, 1.0, v + 0.5, crossing);
+      clipLines(crossing, -(u + 0.5), -1.0, -(v - 0.5), next);
+    }
+    else
+    {
+      clipLines(lines[depth], u - 0.5, 1.0, v + 0.5, crossing);
+      clipLines(crossing, -(u + 0.5), -1.0, -(v + 0.5), next);
+    }
+    if (!hasArea(next))
+      continue;
+
+    size_t bit = static_cast<size_t>(dz + radius) * side + (dx + radius);
+    window[bit / 64] |= uint64_t(1) << (bit % 64);
+    sweepLines(x, z, octant, nextU, nextV, lines, depth + 1, window);
+  }
+}
+
+const BitGrid *PotentiallyVisibleSet::visibleFrom(int x, int z)
+{
+  if (!isReady() || x < 0 || x >= width || z < 0 || z >= height)
+    return nullptr;
+  if (hasDecoded && decodedX == x && decodedZ == z)
+    return &decoded;
+
+  size_t cell = static_cast<size_t>(z) * width + x;
+  if (offsets[cell] == offsets[cell + 1])
+    return nullptr;
+
+  const int side = 2 * radius + 1;
+  decoded = BitGrid(side, side);
+  const uint8_t *in = runs.data() + offsets[cell];
+  const uint8_t *end = runs.data() + offsets[cell + 1];
+  int bit = 0;
+  bool value = false;
+  while (in < end)
+  {
+    int run = static_cast<int>(readVarint(in));
+    // Runs may wrap across window rows; fill them a row span at a time
+    while (value && run > 0)
+    {
+      int row = bit / side, column = bit % side;
+      int span = std::min(run, side - column);
+      decoded.assignSpan(row, column, column + span, true);
+      bit += span;
+      run -= span;
+    }
+    bit += run;
+    value = !value;
+  }
+
+  decodedX = x;
+  decodedZ = z;
+  hasDecoded = true;
+  return &decoded;
+}
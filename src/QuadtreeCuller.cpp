@@ -0,0 +1,74 @@
+#include "QuadtreeCuller.h"
+#include "ChunkedWorld.h"
+#include "MazeGeometry.h"
+#include <algorithm>
+
+static int floorDiv(int value, int divisor)
+{
+  return (value >= 0 ? value : value - divisor + 1) / divisor;
+}
+
+template <typename Maze>
+void QuadtreeCuller::collect(const Maze &maze, const FrustumCuller &frustum, int x, int z, int w, int h,
+                             std::vector<glm::ivec2> &visible, std::vector<glm::ivec2> &candidates)
+{
+  stats = Stats();
+  if (w <= 0 || h <= 0)
+    return;
+
+  // Roots are the ROOT_SIZE-aligned regions overlapping the window (floor division, so negative
+  // world coordinates line up with the chunk grid too). The window is (x0, z0, x1, z1), end-exclusive.
+  glm::ivec4 window(x, z, x + w, z + h);
+  int rootX0 = floorDiv(x, ROOT_SIZE), rootX1 = floorDiv(x + w - 1, ROOT_SIZE);
+  int rootZ0 = floorDiv(z, ROOT_SIZE), rootZ1 = floorDiv(z + h - 1, ROOT_SIZE);
+  for (int rootZ = rootZ0; rootZ <= rootZ1; ++rootZ)
+    for (int rootX = rootX0; rootX <= rootX1; ++rootX)
+      visitNode(maze, frustum, rootX * ROOT_SIZE, rootZ * ROOT_SIZE, ROOT_SIZE, window, visible, candidates);
+}
+
+template <typename Maze>
+void QuadtreeCuller::visitNode(const Maze &maze, const FrustumCuller &frustum, int nodeX, int nodeZ, int size,
+                               const glm::ivec4 &window, std::vector<glm::ivec2> &visible, std::vector<glm::ivec2> &candidates)
+{
+  using namespace MazeGeometry;
+
+  int x0 = std::max(nodeX, window.x), z0 = std::max(nodeZ, window.y);
+  int x1 = std::min(nodeX + size, window.z), z1 = std::min(nodeZ + size, window.w);
+  if (x0 >= x1 || z0 >= z1)
+    return;
+
+  // Union of the cell bounds of the clipped node
+  AABB bounds(glm::vec3(cellBounds(x0, z0).min.x, 0.0f, cellBounds(x0, z0).min.z),
+              glm::vec3(cellBounds(x1 - 1, z1 - 1).max.x, WALL_HEIGHT, cellBounds(x1 - 1, z1 - 1).max.z));
+  stats.nodesVisited++;
+  FrustumTest test = frustum.classifyAABB(bounds);
+
+  if (test == FrustumTest::OUTSIDE)
+  {
+    stats.nodesCulled++;
+    maze.forEachFloorCell(x0, z0, x1 - x0, z1 - z0, [this](int, int)
+                          { stats.cellsCulled++; });
+    return;
+  }
+
+  if (test == FrustumTest::INSIDE || size <= LEAF_SIZE)
+  {
+    if (test == FrustumTest::INSIDE)
+      stats.nodesInside++;
+    std::vector<glm::ivec2> &cells = test == FrustumTest::INSIDE ? visible : candidates;
+    maze.forEachFloorCell(x0, z0, x1 - x0, z1 - z0, [&cells](int x, int z)
+                          { cells.push_back(glm::ivec2(x, z)); });
+    return;
+  }
+
+  int half = size / 2;
+  for (int childZ = 0; childZ < 2; ++childZ)
+    for (int childX = 0; childX < 2; ++childX)
+      visitNode(maze, frustum, nodeX + childX * half, nodeZ + childZ * half, half, window, visible, candidates);
+}
+
+// The mazes rendered through the cell-walk paths
+template void QuadtreeCuller::collect<MazeGenerator>(const MazeGenerator &, const FrustumCuller &, int, int, int, int,
+                                                      std::vector<glm::ivec2> &, std::vector<glm::ivec2> &);
+template void QuadtreeCuller::collect<ChunkedWorld>(const ChunkedWorld &, const FrustumCuller &, int, int, int, int,
+                                                     std::vector<glm::ivec2> &, std::vector<glm::ivec2> &);
@@ -0,0 +1,141 @@
+#include "RenderQueue.h"
+#include <algorithm>
+
+// Key layout, most significant first: program (8) | texture (8) | mesh (8) | depth (24) | unused (16)
+static const int PROGRAM_SHIFT = 56;
+static const int TEXTURE_SHIFT = 48;
+static const int MESH_SHIFT = 40;
+static const int DEPTH_SHIFT = 16;
+static const uint32_t DEPTH_MAX = (1u << 24) - 1;
+
+void RenderQueue::clear()
+{
+  programs.clear();
+  textures.clear();
+  meshes.clear();
+  items.clear();
+  keys.clear();
+  order.clear();
+}
+
+int RenderQueue::addProgram(const Shader &shader, const char *colorUniform)
+{
+  Program program;
+  program.shader = &shader;
+  program.model = shader.uniform("model");
+  program.color = shader.uniform(colorUniform);
+  programs.push_back(program);
+  return static_cast<int>(programs.size()) - 1;
+}
+
+int RenderQueue::textureSlot(unsigned int texture)
+{
+  auto it = std::find(textures.begin(), textures.end(), texture);
+  if (it != textures.end())
+    return static_cast<int>(it - textures.begin());
+  textures.push_back(texture);
+  return static_cast<int>(textures.size()) - 1;
+}
+
+int RenderQueue::meshSlot(const Mesh *mesh)
+{
+  auto it = std::find(meshes.begin(), meshes.end(), mesh);
+  if (it != meshes.end())
+    return static_cast<int>(it - meshes.begin());
+  meshes.push_back(mesh);
+  return static_cast<int>(meshes.size()) - 1;
+}
+
+void RenderQueue::submit(int program, unsigned int texture, const Mesh &mesh, const glm::mat4 &model, const glm::vec3 &color, float depth)
+{
+  float normalized = std::min(std::max(depth / MAX_DEPTH, 0.0f), 1.0f);
+  uint64_t quantizedDepth = static_cast<uint64_t>(normalized * DEPTH_MAX);
+
+  uint64_t key = (static_cast<uint64_t>(program & 0xFF) << PROGRAM_SHIFT) |
+                 (static_cast<uint64_t>(textureSlot(texture) & 0xFF) << TEXTURE_SHIFT) |
+                 (static_cast<uint64_t>(meshSlot(&mesh) & 0xFF) << MESH_SHIFT) |
+                 (quantizedDepth << DEPTH_SHIFT);
+
+  order.push_back(static_cast<uint32_t>(items.size()));
+  keys.push_back(key);
+  items.push_back({&mesh, texture, program, model, color});
+}
+
+void RenderQueue::radixSort()
+{
+  // LSD radix sort, one byte per pass, skipping the always-zero low 16 bits.
+  // Stable, so equal keys keep submission order.
+  const size_t count = keys.size();
+  keysScratch.resize(count);
+  orderScratch.resize(count);
+
+  for (int shift = DEPTH_SHIFT; shift < 64; shift += 8)
+  {
+    size_t offsets[257] = {0};
+    for (size_t i = 0; i < count; ++i)
+      offsets[((keys[i] >> shift) & 0xFF) + 1]++;
+
+    // Every key shares this byte: nothing to reorder
+    if (offsets[((keys[0] >> shift) & 0xFF) + 1] == count)
+      continue;
+
+    for (int b = 0; b < 256; ++b)
+      offsets[b + 1] += offsets[b];
+
+    for (size_t i = 0; i < count; ++i)
+    {
+      size_t dst = offsets[(keys[i] >> shift) & 0xFF]++;
+      keysScratch[dst] = keys[i];
+      orderScratch[dst] = order[i];
+    }
+    keys.swap(keysScratch);
+    order.swap(orderScratch);
+  }
+}
+
+void RenderQueue::flush()
+{
+  stats = Stats();
+  if (items.empty())
+    return;
+
+  if (sorting)
+    radixSort();
+
+  int currentProgram = -1;
+  unsigned int currentTexture = 0;
+  const Mesh *currentMesh = nullptr;
+
+  glActiveTexture(GL_TEXTURE0);
+  for (uint32_t index : order)
+  {
+    const Item &item = items[index];
+    const Program &program = programs[item.program];
+
+    if (item.program != currentProgram)
+    {
+      program.shader->use();
+      currentProgram = item.program;
+      stats.programBinds++;
+    }
+    if (item.texture != 0 && item.texture != currentTexture)
+    {
+      glBindTexture(GL_TEXTURE_2D, item.texture);
+      currentTexture = item.texture;
+      stats.textureBinds++;
+    }
+    if (item.mesh != currentMesh)
+    {
+      glBindVertexArray(item.mesh->getVAO());
+      currentMesh = item.mesh;
+      stats.meshBinds++;
+    }
+
+    program.shader->setMat4(program.model, item.model);
+    program.shader->setVec3(program.color, item.color);
+    glDrawElements(GL_TRIANGLES, item.mesh->getIndexCount(), GL_UNSIGNED_INT, 0);
+    stats.draws++;
+  }
+
+  glBindVertexArray(0);
+}
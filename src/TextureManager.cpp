@@ -1,6 +1,7 @@
 #include "TextureManager.h"
 #include <stb_image.h>
 #include <iostream>
+#include <algorithm>
 
 unsigned int TextureManager::loadTexture(const std::string &path)
 {
@@ -51,6 +52,109 @@ unsigned int TextureManager::loadTexture(const std::string &path)
   return textureID;
 }
 
+// Bilinear resample of an RGBA8 image
+static std::vector<unsigned char> resampleRGBA(const unsigned char *src, int srcWidth, int srcHeight, int width, int height)
+{
+  std::vector<unsigned char> dst(static_cast<size_t>(width) * height * 4);
+  for (int y = 0; y < height; ++y)
+  {
+    float fy = std::max((y + 0.5f) * srcHeight / height - 0.5f, 0.0f);
+    int y0 = std::min(static_cast<int>(fy), srcHeight - 1);
+    int y1 = std::min(y0 + 1, srcHeight - 1);
+    float ty = fy - y0;
+
+    for (int x = 0; x < width; ++x)
+    {
+      float fx = std::max((x + 0.5f) * srcWidth / width - 0.5f, 0.0f);
+      int x0 = std::min(static_cast<int>(fx), srcWidth - 1);
+      int x1 = std::min(x0 + 1, srcWidth - 1);
+      float tx = fx - x0;
+
+      for (int c = 0; c < 4; ++c)
+      {
+        float top = src[(y0 * srcWidth + x0) * 4 + c] * (1.0f - tx) + src[(y0 * srcWidth + x1) * 4 + c] * tx;
+        float bottom = src[(y1 * srcWidth + x0) * 4 + c] * (1.0f - tx) + src[(y1 * srcWidth + x1) * 4 + c] * tx;
+        dst[(static_cast<size_t>(y) * width + x) * 4 + c] = static_cast<unsigned char>(top * (1.0f - ty) + bottom * ty + 0.5f);
+      }
+    }
+  }
+  return dst;
+}
+
+unsigned int TextureManager::loadTextureArray(const std::vector<std::string> &paths)
+{
+  std::string key = "array:";
+  for (const auto &path : paths)
+    key += path + ";";
+
+  auto it = loadedTextures.find(key);
+  if (it != loadedTextures.end())
+  {
+    return it->second;
+  }
+
+  unsigned int textureID;
+  glGenTextures(1, &textureID);
+  glBindTexture(GL_TEXTURE_2D_ARRAY, textureID);
+
+  int layerWidth = 0, layerHeight = 0;
+  for (size_t layer = 0; layer < paths.size(); ++layer)
+  {
+    // Force RGBA so every layer shares one internal format
+    int width, height, nrComponents;
+    unsigned char *data = stbi_load(paths[layer].c_str(), &width, &height, &nrComponents, 4);
+    if (!data)
+    {
+      std::cout << "Texture failed to load at path: " << paths[layer] << std::endl;
+      if (layer == 0)
+      {
+        glDeleteTextures(1, &textureID);
+        return 0;
+      }
+      continue;
+    }
+
+    if (layer == 0)
+    {
+      layerWidth = width;
+      layerHeight = height;
+      glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA8, layerWidth, layerHeight, static_cast<GLsizei>(paths.size()),
+                   0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    }
+
+    if (width != layerWidth || height != layerHeight)
+    {
+      std::cout << "Resampling " << paths[layer] << " from " << width << "x" << height
+                << " to " << layerWidth << "x" << layerHeight << " for texture array" << std::endl;
+      std::vector<unsigned char> resized = resampleRGBA(data, width, height, layerWidth, layerHeight);
+      glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, static_cast<GLint>(layer), layerWidth, layerHeight, 1,
+                      GL_RGBA, GL_UNSIGNED_BYTE, resized.data());
+    }
+    else
+    {
+      glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, static_cast<GLint>(layer), layerWidth, layerHeight, 1,
+                      GL_RGBA, GL_UNSIGNED_BYTE, data);
+    }
+
+    stbi_image_free(data);
+  }
+
+  // Mip levels of an array texture are per layer, so layers never bleed into each other
+  glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+
+  glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_REPEAT);
+  glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_REPEAT);
+  glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+  glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+  loadedTextures[key] = textureID;
+
+  std::cout << "Loaded texture array: " << paths.size() << " layers of " << layerWidth << "x" << layerHeight
+            << " (ID: " << textureID << ")" << std::endl;
+
+  return textureID;
+}
+
 unsigned int TextureManager::getTexture(const std::string &path)
 {
   return loadTexture(path); // Will return cached version if already loaded
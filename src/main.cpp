@@ -10,8 +10,20 @@
 #include "TextureManager.h"
 #include "Primitives.h"
 #include "MazeGenerator.h"
+#include "ChunkedWorld.h"
+#include "ChunkStreamer.h"
 #include "FrustumCuller.h"
+#include "QuadtreeCuller.h"
+#include "PotentiallyVisibleSet.h"
+#include "OcclusionCuller.h"
 #include "Player.h"
+#include "MazeGeometry.h"
+#include "ChunkMesh.h"
+#include "InstanceBatch.h"
+#include "FrameUniforms.h"
+#include "RenderQueue.h"
+#include "GpuCuller.h"
+#include "HeadlessContext.h"
 
 // ImGui includes
 #include "imgui/imgui.h"
@@ -21,7 +33,14 @@
 #include <iostream>
 #include <vector>
 #include <memory>
+#include <array>
 #include <ctime>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+#include <algorithm>
+#include <cmath>
 
 // Function declarations
 void framebuffer_size_callback(GLFWwindow *window, int width, int height);
@@ -29,13 +48,31 @@ void mouse_callback(GLFWwindow *window, double xpos, double ypos);
 void scroll_callback(GLFWwindow *window, double xoffset, double yoffset);
 void key_callback(GLFWwindow *window, int key, int scancode, int action, int mods);
 void processInput(GLFWwindow *window);
-void setupLighting(Shader &shader, const Camera &camera);
-void renderMaze(const MazeGenerator &maze, Shader &shader, Shader &lightShader, Mesh &wallMesh, Mesh &floorMesh, Mesh &ceilingMesh,
+void updateFrameUniforms(const glm::mat4 &projection, const glm::mat4 &view, const Camera &camera);
+template <typename Maze, typename Fn>
+void forEachVisibleCell(const Maze &maze, int centerX, int centerZ, int renderDistance, Fn &&fn);
+const BitGrid *cameraVisibility(const MazeGenerator &maze);
+const BitGrid *cameraVisibility(const ChunkedWorld &world);
+bool depthPyramidNeeded();
+template <typename Maze>
+void renderMaze(const Maze &maze, Shader &shader, Shader &lightShader, Mesh &wallMesh, Mesh &floorMesh, Mesh &ceilingMesh,
                 unsigned int wallTex, unsigned int floorTex, unsigned int ceilingTex);
+void collectVisibleChunks(const ChunkMeshBuilder &chunkMeshes, std::vector<const ChunkMesh *> &visibleChunks);
+void renderMazeChunks(const ChunkMeshBuilder &chunkMeshes, Shader &shader, Shader &lightShader,
+                      unsigned int wallTex, unsigned int floorTex, unsigned int ceilingTex);
+void renderMazeChunksArray(const ChunkMeshBuilder &chunkMeshes, Shader &arrayShader, unsigned int materialArray);
+void renderMazeChunksIndirect(Shader &arrayShader, unsigned int materialArray);
+void bindMaterialArray(Shader &arrayShader, unsigned int materialArray);
+template <typename Maze>
+void renderMazeInstanced(const Maze &maze, Shader &shader, Shader &lightShader,
+                         unsigned int wallTex, unsigned int floorTex, unsigned int ceilingTex);
 void renderUI(const Camera &camera, MazeGenerator &maze, GLFWwindow *window);
 void toggleFullscreen(GLFWwindow *window);
 void setResolution(GLFWwindow *window, int width, int height);
 void updateProjectionMatrix();
+bool parseArguments(int argc, char **argv);
+void updateBenchmarkCamera(int frame, int frameCount, const MazeGenerator &maze);
+void printFrameTimes(const char *label, std::vector<double> milliseconds);
 
 // Settings
 const unsigned int SCR_WIDTH = 1200;
@@ -91,72 +128,225 @@ FrustumCuller frustumCuller;
 bool enableFrustumCulling = true;
 int cellsRendered = 0;
 int cellsCulled = 0;
+int chunksRendered = 0;
+int chunksCulled = 0;
+int drawCalls = 0;
+// Chunk-aligned quadtree in front of the per-cell tests (off: every cell is tested)
+QuadtreeCuller quadtreeCuller;
+bool useQuadtreeCulling = true;
+int cellsTested = 0;
+// Cells visible from each floor cell of the fixed maze, built on worker threads whenever it changes
+PotentiallyVisibleSet pvs;
+const int PVS_RADIUS = 18; // the render distance; windows are centred on the camera's cell
+bool usePvs = true;
+bool pvsDirty = true;
+int cellsHiddenByPvs = 0;
+// Exact visibility from the camera's position, swept over the render window every frame
+OcclusionCuller occlusionCuller;
+bool enableOcclusionCulling = true;
+int cellsOccluded = 0;
+// CPU depth buffer of the wall faces nearest the camera, tested against cells and chunks the frustum keeps
+bool useDepthOcclusion = true;
+const int OCCLUDER_RADIUS = 12;
+int cellsHiddenByDepth = 0;
+// Scratch for batched frustum tests: accepted cells, candidate cells, their bounds and which of them passed
+std::vector<glm::ivec2> acceptedCells;
+std::vector<glm::ivec2> cullCells;
+AABBArray cullBounds;
+std::vector<uint64_t> cullVisible;
+
+// Maze render paths (selectable at runtime for A/B frame-time comparison)
+enum RenderPath
+{
+  RENDER_PATH_PER_CELL,
+  RENDER_PATH_BAKED_CHUNKS,
+  RENDER_PATH_INSTANCED,
+  RENDER_PATH_COUNT
+};
+const char *renderPathNames[RENDER_PATH_COUNT] = {"Per-Cell Draws", "Baked Chunks", "Instanced"};
+int renderPath = RENDER_PATH_BAKED_CHUNKS;
+
+// Baked chunk geometry, rebuilt only when the maze changes
+ChunkMeshBuilder chunkMeshes;
+bool mazeMeshDirty = true;
+// Draw each baked chunk in one call, sampling every material from a texture array
+bool useTextureArray = true;
+// Texture-array shader uniforms, resolved once when the shader loads
+struct MaterialArrayUniforms
+{
+    UniformHandle model;
+    UniformHandle materials;
+    UniformHandle layer[PIECE_COUNT];
+    UniformHandle color[PIECE_COUNT];
+    UniformHandle emission[PIECE_COUNT];
+} materialArrayUniforms;
+// GL 4.3+: cull chunks in a compute shader and draw them with one indirect multi-draw
+GpuCuller gpuCuller;
+bool useGpuCulling = true;
+
+// Per-frame instance streams, one per maze piece
+std::array<InstanceBatch, PIECE_COUNT> instanceBatches;
+int instancesDrawn = 0;
+
+// Camera and lighting state shared by all programs through one uniform block
+FrameUniformBuffer frameUniforms;
+
+// Sorted draw list for the per-cell path
+RenderQueue renderQueue;
 
 // Player system
 std::unique_ptr<Player> player;
 
-int main()
+// Infinite world mode: chunks streamed in around the camera replace the fixed maze
+ChunkedWorld world(12345);
+ChunkStreamer chunkStreamer;
+bool infiniteWorld = false;
+
+// Maze file loaded at startup (--maze) and used by the Save/Load buttons
+std::string mazeFilePath = "maze.bkmz";
+bool loadMazeFile = false;
+
+// Headless benchmark (--headless): offscreen context, scripted camera path, frame-time report
+bool headless = false;
+int benchmarkFrames = 600;
+int benchmarkWarmupFrames = 10; // rendered but not measured (first uploads, first-query driver quirks)
+
+int main(int argc, char **argv)
 {
-    glfwInit();
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
-    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    if (!parseArguments(argc, argv))
+        return -1;
 
-    GLFWwindow *window = glfwCreateWindow(SCR_WIDTH, SCR_HEIGHT, "Backrooms - Infinite Maze", NULL, NULL);
-    if (window == NULL)
+    GLFWwindow *window = NULL;
+    HeadlessContext headlessContext;
+    unsigned int benchmarkFBO = 0;
+    unsigned int benchmarkRenderbuffers[2] = {0, 0};
+
+    if (headless)
     {
-        std::cout << "Failed to create GLFW window" << std::endl;
-        glfwTerminate();
-        return -1;
+        if (!headlessContext.create())
+            return -1;
+        if (!gladLoadGLLoader((GLADloadproc)HeadlessContext::getProcAddress))
+        {
+            std::cout << "Failed to initialize GLAD" << std::endl;
+            return -1;
+        }
+        std::cout << "Renderer: " << glGetString(GL_RENDERER) << " (OpenGL " << glGetString(GL_VERSION) << ")" << std::endl;
+
+        // Nothing is presented; render into an offscreen colour + depth target
+        glGenFramebuffers(1, &benchmarkFBO);
+        glGenRenderbuffers(2, benchmarkRenderbuffers);
+        glBindFramebuffer(GL_FRAMEBUFFER, benchmarkFBO);
+        glBindRenderbuffer(GL_RENDERBUFFER, benchmarkRenderbuffers[0]);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, currentWidth, currentHeight);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, benchmarkRenderbuffers[0]);
+        glBindRenderbuffer(GL_RENDERBUFFER, benchmarkRenderbuffers[1]);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, currentWidth, currentHeight);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, benchmarkRenderbuffers[1]);
+        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+        {
+            std::cout << "Offscreen framebuffer is incomplete" << std::endl;
+            return -1;
+        }
+        glViewport(0, 0, currentWidth, currentHeight);
     }
+    else
+    {
+        glfwInit();
+        // Prefer 4.3 for GPU-driven culling; fall back to 3.3 where it isn't available
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+        glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+
+        window = glfwCreateWindow(SCR_WIDTH, SCR_HEIGHT, "Backrooms - Infinite Maze", NULL, NULL);
+        if (window == NULL)
+        {
+            glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+            glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+            window = glfwCreateWindow(SCR_WIDTH, SCR_HEIGHT, "Backrooms - Infinite Maze", NULL, NULL);
+        }
+        if (window == NULL)
+        {
+            std::cout << "Failed to create GLFW window" << std::endl;
+            glfwTerminate();
+            return -1;
+        }
 
-    // Initialize current resolution
-    currentWidth = SCR_WIDTH;
-    currentHeight = SCR_HEIGHT;
-    windowedWidth = SCR_WIDTH;
-    windowedHeight = SCR_HEIGHT;
+        // Initialize current resolution
+        currentWidth = SCR_WIDTH;
+        currentHeight = SCR_HEIGHT;
+        windowedWidth = SCR_WIDTH;
+        windowedHeight = SCR_HEIGHT;
 
-    glfwMakeContextCurrent(window);
-    glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
-    glfwSetCursorPosCallback(window, mouse_callback);
-    glfwSetScrollCallback(window, scroll_callback);
-    glfwSetKeyCallback(window, key_callback);
+        glfwMakeContextCurrent(window);
+        glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
+        glfwSetCursorPosCallback(window, mouse_callback);
+        glfwSetScrollCallback(window, scroll_callback);
+        glfwSetKeyCallback(window, key_callback);
 
-    glfwSwapInterval(0);
-    glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+        glfwSwapInterval(0);
+        glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
 
-    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
-    {
-        std::cout << "Failed to initialize GLAD" << std::endl;
-        return -1;
-    }
+        if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+        {
+            std::cout << "Failed to initialize GLAD" << std::endl;
+            return -1;
+        }
 
-    // Setup ImGui
-    IMGUI_CHECKVERSION();
-    ImGui::CreateContext();
-    ImGuiIO &io = ImGui::GetIO();
-    io.ConfigFlags |= ImGuiConfigFlags_NavEnableKeyboard;
+        // Setup ImGui
+        IMGUI_CHECKVERSION();
+        ImGui::CreateContext();
+        ImGuiIO &io = ImGui::GetIO();
+        io.ConfigFlags |= ImGuiConfigFlags_NavEnableKeyboard;
 
-    ImGui::StyleColorsDark();
-    ImGui_ImplGlfw_InitForOpenGL(window, true);
-    ImGui_ImplOpenGL3_Init("#version 330");
+        ImGui::StyleColorsDark();
+        ImGui_ImplGlfw_InitForOpenGL(window, true);
+        ImGui_ImplOpenGL3_Init("#version 330");
+    }
 
     glEnable(GL_DEPTH_TEST);
 
     Shader backroomsShader("data/shaders/backrooms.vs", "data/shaders/backrooms.fs");
     Shader lightTileShader("data/shaders/lightTile.vs", "data/shaders/lightTile.fs");
+    Shader backroomsInstancedShader("data/shaders/backroomsInstanced.vs", "data/shaders/backrooms.fs");
+    Shader lightTileInstancedShader("data/shaders/lightTileInstanced.vs", "data/shaders/lightTile.fs");
+    Shader backroomsArrayShader("data/shaders/backroomsArray.vs", "data/shaders/backroomsArray.fs");
+
+    frameUniforms.init();
+    for (const Shader *shader : {&backroomsShader, &lightTileShader, &backroomsInstancedShader, &lightTileInstancedShader,
+                                 &backroomsArrayShader})
+        frameUniforms.attach(*shader);
+    materialArrayUniforms.model = backroomsArrayShader.uniform("model");
+    materialArrayUniforms.materials = backroomsArrayShader.uniform("materials");
+    for (int piece = 0; piece < PIECE_COUNT; ++piece)
+    {
+        std::string index = "[" + std::to_string(piece) + "]";
+        materialArrayUniforms.layer[piece] = backroomsArrayShader.uniform("materialLayer" + index);
+        materialArrayUniforms.color[piece] = backroomsArrayShader.uniform("materialColor" + index);
+        materialArrayUniforms.emission[piece] = backroomsArrayShader.uniform("materialEmission" + index);
+    }
+    gpuCuller.init();
 
     auto wallMesh = Primitives::createWall(2.0f, 3.0f);
     auto floorMesh = Primitives::createFloor(2.0f, 2.0f);
     auto ceilingMesh = Primitives::createCeiling(2.0f, 2.0f);
 
+    instanceBatches[PIECE_FLOOR].init(floorMesh);
+    instanceBatches[PIECE_CEILING].init(ceilingMesh);
+    instanceBatches[PIECE_LIGHT_TILE].init(ceilingMesh);
+    instanceBatches[PIECE_WALL].init(wallMesh);
+
     auto &texManager = TextureManager::getInstance();
     unsigned int wallTexture = texManager.loadTexture("data/textures/backrooms_wall.png");
     unsigned int floorTexture = texManager.loadTexture("data/textures/backrooms_floor.png");
     unsigned int ceilingTexture = texManager.loadTexture("data/textures/backrooms_ceiling.png");
+    // Layers: 0 floor, 1 ceiling, 2 wall
+    unsigned int materialArray = texManager.loadTextureArray({"data/textures/backrooms_floor.png",
+                                                              "data/textures/backrooms_ceiling.png",
+                                                              "data/textures/backrooms_wall.png"});
 
     MazeGenerator maze(75, 75, 12345);
-    maze.generateMaze();
+    if (!loadMazeFile || !maze.load(mazeFilePath))
+        maze.generateMaze();
 
     // Initialize player controller
     player = std::make_unique<Player>(&camera, glm::vec3(50.0f, 0.1f, 50.0f));
@@ -166,42 +356,156 @@ int main()
 
     std::cout << "Generated maze with " << maze.getWidth() << "x" << maze.getHeight() << " cells" << std::endl;
 
+    // Headless timing: CPU time per frame, GPU time from one GL_TIME_ELAPSED query per frame
+    std::vector<double> cpuFrameTimes;
+    std::vector<double> gpuFrameTimes;
+    std::vector<unsigned int> gpuTimerQueries(headless ? benchmarkFrames : 0);
+    if (headless)
+        glGenQueries(benchmarkFrames, gpuTimerQueries.data());
+    int frameIndex = -benchmarkWarmupFrames;
+
+    chunkStreamer.start();
+    glm::vec3 lastCameraPosition = camera.Position;
+
     // Render loop
-    while (!glfwWindowShouldClose(window))
+    while (headless ? frameIndex < benchmarkFrames : !glfwWindowShouldClose(window))
     {
-        float currentFrame = static_cast<float>(glfwGetTime());
-        deltaTime = currentFrame - lastFrame;
-        lastFrame = currentFrame;
+        auto cpuFrameStart = std::chrono::steady_clock::now();
+        bool measured = headless && frameIndex >= 0;
+
+        if (headless)
+        {
+            // Fixed timestep keeps the scripted run identical between machines
+            deltaTime = 1.0f / 60.0f;
+            updateBenchmarkCamera(std::max(frameIndex, 0), benchmarkFrames, maze);
+            if (measured)
+                glBeginQuery(GL_TIME_ELAPSED, gpuTimerQueries[frameIndex]);
+        }
+        else
+        {
+            float currentFrame = static_cast<float>(glfwGetTime());
+            deltaTime = currentFrame - lastFrame;
+            lastFrame = currentFrame;
 
-        processInput(window);
+            processInput(window);
 
-        // Update player (handles physics, collision, camera positioning)
-        player->Update(deltaTime, maze);
+            // Update player (handles physics, collision, camera positioning)
+            if (infiniteWorld)
+                player->Update(deltaTime, world);
+            else
+                player->Update(deltaTime, maze);
 
-        renderUI(camera, maze, window);
+            renderUI(camera, maze, window);
+        }
+
+        // Stream chunks in around the camera on worker threads; velocity is measured from the camera
+        // so it covers both god mode and player physics
+        if (infiniteWorld)
+        {
+            glm::vec3 cameraVelocity = deltaTime > 0.0f ? (camera.Position - lastCameraPosition) / deltaTime : glm::vec3(0.0f);
+            chunkStreamer.update(world, camera.Position, camera.Front, cameraVelocity);
+        }
+        lastCameraPosition = camera.Position;
 
         glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-        backroomsShader.use();
+        // The instanced path reads model matrices from vertex attributes instead of a uniform
+        Shader &mazeShader = (renderPath == RENDER_PATH_INSTANCED) ? backroomsInstancedShader : backroomsShader;
+        Shader &mazeLightShader = (renderPath == RENDER_PATH_INSTANCED) ? lightTileInstancedShader : lightTileShader;
 
         glm::mat4 projection = glm::perspective(glm::radians(camera.Zoom), (float)currentWidth / (float)currentHeight, 0.1f, 100.0f);
         glm::mat4 view = camera.GetViewMatrix();
-        backroomsShader.setMat4("projection", projection);
-        backroomsShader.setMat4("view", view);
 
         // Update culling systems
         if (enableFrustumCulling)
         {
             frustumCuller.updateFrustum(projection * view);
         }
+        if (depthPyramidNeeded())
+        {
+            occlusionCuller.clearOccluders();
+            if (infiniteWorld)
+                occlusionCuller.addWallOccluders(world, camera.Position, OCCLUDER_RADIUS);
+            else
+                occlusionCuller.addWallOccluders(maze, camera.Position, OCCLUDER_RADIUS);
+            occlusionCuller.rasterize(projection * view);
+        }
+        else
+        {
+            occlusionCuller.invalidateDepth();
+        }
 
         cellsRendered = 0;
         cellsCulled = 0;
+        cellsTested = 0;
+        cellsHiddenByPvs = 0;
+        cellsOccluded = 0;
+        cellsHiddenByDepth = 0;
+        chunksRendered = 0;
+        chunksCulled = 0;
+        drawCalls = 0;
+        instancesDrawn = 0;
+
+        if (pvsDirty)
+        {
+            pvs.build(maze, PVS_RADIUS);
+            pvsDirty = false;
+        }
+
+        if (mazeMeshDirty)
+        {
+            chunkMeshes.rebuild(maze, wallMesh, floorMesh, ceilingMesh);
+            gpuCuller.setChunks(chunkMeshes);
+            mazeMeshDirty = false;
+        }
+
+        updateFrameUniforms(projection, view, camera);
+        if (renderPath == RENDER_PATH_BAKED_CHUNKS && useGpuCulling && gpuCuller.isReady())
+        {
+            renderMazeChunksIndirect(backroomsArrayShader, materialArray);
+        }
+        else if (renderPath == RENDER_PATH_BAKED_CHUNKS && useTextureArray)
+        {
+            renderMazeChunksArray(chunkMeshes, backroomsArrayShader, materialArray);
+        }
+        else if (renderPath == RENDER_PATH_BAKED_CHUNKS)
+        {
+            renderMazeChunks(chunkMeshes, mazeShader, mazeLightShader,
+                             wallTexture, floorTexture, ceilingTexture);
+        }
+        else if (renderPath == RENDER_PATH_INSTANCED && infiniteWorld)
+        {
+            renderMazeInstanced(world, mazeShader, mazeLightShader,
+                                wallTexture, floorTexture, ceilingTexture);
+        }
+        else if (renderPath == RENDER_PATH_INSTANCED)
+        {
+            renderMazeInstanced(maze, mazeShader, mazeLightShader,
+                                wallTexture, floorTexture, ceilingTexture);
+        }
+        else if (infiniteWorld)
+        {
+            renderMaze(world, mazeShader, mazeLightShader, wallMesh, floorMesh, ceilingMesh,
+                       wallTexture, floorTexture, ceilingTexture);
+        }
+        else
+        {
+            renderMaze(maze, mazeShader, mazeLightShader, wallMesh, floorMesh, ceilingMesh,
+                       wallTexture, floorTexture, ceilingTexture);
+        }
 
-        setupLighting(backroomsShader, camera);
-        renderMaze(maze, backroomsShader, lightTileShader, wallMesh, floorMesh, ceilingMesh,
-                   wallTexture, floorTexture, ceilingTexture);
+        if (headless)
+        {
+            // glFlush keeps the driver from batching frames; query results are collected after the run
+            if (measured)
+                glEndQuery(GL_TIME_ELAPSED);
+            glFlush();
+            if (measured)
+                cpuFrameTimes.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - cpuFrameStart).count());
+            frameIndex++;
+            continue;
+        }
 
         ImGui::Render();
         ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
@@ -210,6 +514,46 @@ int main()
         glfwPollEvents();
     }
 
+    if (headless)
+    {
+        glFinish();
+        for (unsigned int query : gpuTimerQueries)
+        {
+            GLuint64 elapsed = 0;
+            glGetQueryObjectui64v(query, GL_QUERY_RESULT, &elapsed);
+            gpuFrameTimes.push_back(elapsed / 1.0e6);
+        }
+        glDeleteQueries(benchmarkFrames, gpuTimerQueries.data());
+
+        std::cout << "Headless benchmark: " << benchmarkFrames << " frames at " << currentWidth << "x" << currentHeight
+                  << ", render path \"" << renderPathNames[renderPath] << "\"" << std::endl;
+        printFrameTimes("CPU", cpuFrameTimes);
+        printFrameTimes("GPU", gpuFrameTimes);
+        if (infiniteWorld)
+        {
+            const ChunkStreamer::Stats &streamStats = chunkStreamer.getStats();
+            std::printf("  Chunk streaming: %d generated, %.3f ms avg (%.3f max) per chunk, %.2f ms avg (%.2f max) to resident, %zu KB resident\n",
+                        streamStats.completedTotal, streamStats.generateMs, streamStats.generateMaxMs,
+                        streamStats.latencyMs, streamStats.latencyMaxMs, world.getMemoryUsage() / 1024);
+        }
+    }
+
+    chunkStreamer.stop();
+    chunkMeshes.release();
+    gpuCuller.release();
+    for (auto &batch : instanceBatches)
+        batch.release();
+    frameUniforms.release();
+    texManager.cleanup();
+
+    if (headless)
+    {
+        glDeleteRenderbuffers(2, benchmarkRenderbuffers);
+        glDeleteFramebuffers(1, &benchmarkFBO);
+        headlessContext.destroy();
+        return 0;
+    }
+
     ImGui_ImplOpenGL3_Shutdown();
     ImGui_ImplGlfw_Shutdown();
     ImGui::DestroyContext();
@@ -218,160 +562,497 @@ int main()
     return 0;
 }
 
-void renderMaze(const MazeGenerator &maze, Shader &shader, Shader &lightShader, Mesh &wallMesh, Mesh &floorMesh, Mesh &ceilingMesh,
+bool parseArguments(int argc, char **argv)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        const char *arg = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if (std::strcmp(arg, "--headless") == 0)
+        {
+            headless = true;
+        }
+        else if (std::strcmp(arg, "--frames") == 0 && hasValue)
+        {
+            benchmarkFrames = std::max(1, std::atoi(argv[++i]));
+        }
+        else if (std::strcmp(arg, "--size") == 0 && hasValue)
+        {
+            int width = 0, height = 0;
+            if (std::sscanf(argv[++i], "%dx%d", &width, &height) != 2 || width <= 0 || height <= 0)
+            {
+                std::cout << "Invalid --size, expected WIDTHxHEIGHT" << std::endl;
+                return false;
+            }
+            currentWidth = width;
+            currentHeight = height;
+        }
+        else if (std::strcmp(arg, "--render-path") == 0 && hasValue)
+        {
+            const char *names[RENDER_PATH_COUNT] = {"per-cell", "baked", "instanced"};
+            const char *value = argv[++i];
+            auto it = std::find_if(names, names + RENDER_PATH_COUNT, [value](const char *name)
+                                   { return std::strcmp(name, value) == 0; });
+            if (it == names + RENDER_PATH_COUNT)
+            {
+                std::cout << "Unknown render path \"" << value << "\" (per-cell, baked, instanced)" << std::endl;
+                return false;
+            }
+            renderPath = static_cast<int>(it - names);
+        }
+        else if (std::strcmp(arg, "--infinite") == 0)
+        {
+            infiniteWorld = true;
+        }
+        else if (std::strcmp(arg, "--maze") == 0 && hasValue)
+        {
+            mazeFilePath = argv[++i];
+            loadMazeFile = true;
+        }
+        else
+        {
+            std::cout << "Usage: " << argv[0] << " [--headless] [--frames N] [--size WIDTHxHEIGHT]"
+                      << " [--render-path per-cell|baked|instanced] [--infinite] [--maze FILE]" << std::endl;
+            return false;
+        }
+    }
+
+    // Baked chunks are built from the fixed maze; the world is drawn by the cell-walk paths
+    if (infiniteWorld && renderPath == RENDER_PATH_BAKED_CHUNKS)
+        renderPath = RENDER_PATH_INSTANCED;
+    return true;
+}
+
+void updateBenchmarkCamera(int frame, int frameCount, const MazeGenerator &maze)
+{
+    using namespace MazeGeometry;
+
+    // A closed figure-eight over the maze at eye height, looking along the direction of travel
+    const float TWO_PI = 6.28318530718f;
+    float t = TWO_PI * static_cast<float>(frame) / static_cast<float>(frameCount);
+    float extentX = (maze.getWidth() - 1) * CELL_SIZE;
+    float extentZ = (maze.getHeight() - 1) * CELL_SIZE;
+
+    camera.Position = glm::vec3(extentX * (0.5f + 0.4f * std::sin(t)), 1.7f, extentZ * (0.5f + 0.4f * std::sin(2.0f * t)));
+
+    float dx = 0.4f * extentX * std::cos(t);
+    float dz = 0.8f * extentZ * std::cos(2.0f * t);
+    camera.Yaw = glm::degrees(std::atan2(dz, dx));
+    camera.Pitch = 0.0f;
+    camera.ProcessMouseMovement(0.0f, 0.0f); // refreshes Front/Right/Up from Yaw and Pitch
+}
+
+void printFrameTimes(const char *label, std::vector<double> milliseconds)
+{
+    if (milliseconds.empty())
+        return;
+
+    std::sort(milliseconds.begin(), milliseconds.end());
+    double total = 0.0;
+    for (double ms : milliseconds)
+        total += ms;
+
+    auto percentile = [&](double p)
+    {
+        size_t index = static_cast<size_t>(p * (milliseconds.size() - 1) + 0.5);
+        return milliseconds[index];
+    };
+
+    std::printf("  %s frame time (ms): avg %.3f  min %.3f  p50 %.3f  p95 %.3f  p99 %.3f  max %.3f\n",
+                label, total / milliseconds.size(), milliseconds.front(), percentile(0.50), percentile(0.95),
+                percentile(0.99), milliseconds.back());
+}
+
+// The camera cell's potentially visible set, when the fixed maze is drawn and the set is built;
+// nullptr (draw without it) otherwise, including while the camera is inside a wall
+const BitGrid *cameraVisibility(const MazeGenerator &)
+{
+    using namespace MazeGeometry;
+    if (!usePvs || pvsDirty)
+        return nullptr;
+    glm::ivec2 cell = cameraCell(camera.Position);
+    return pvs.visibleFrom(cell.x, cell.y);
+}
+
+const BitGrid *cameraVisibility(const ChunkedWorld &)
+{
+    return nullptr;
+}
+
+// Whether this frame's render path tests boxes against the software depth buffer: the GPU-culled
+// path never does, and the baked chunks only after they've passed the frustum
+bool depthPyramidNeeded()
+{
+    if (!useDepthOcclusion)
+        return false;
+    if (renderPath != RENDER_PATH_BAKED_CHUNKS)
+        return true;
+    return enableFrustumCulling && !(useGpuCulling && gpuCuller.isReady());
+}
+
+// Calls fn(x, z) for every floor cell within renderDistance of (centerX, centerZ) that passes the
+// frustum test and isn't hidden from the camera behind walls. The quadtree settles whole blocks of
+// cells with one test each; the cells left in blocks crossing the frustum edge are tested together
+// in one SIMD batch.
+template <typename Maze, typename Fn>
+void forEachVisibleCell(const Maze &maze, int centerX, int centerZ, int renderDistance, Fn &&fn)
+{
+    using namespace MazeGeometry;
+    int windowX = centerX - renderDistance, windowZ = centerZ - renderDistance;
+    int windowSize = renderDistance * 2 + 1;
+
+    acceptedCells.clear();
+    cullCells.clear();
+    std::vector<glm::ivec2> &allCells = enableFrustumCulling ? cullCells : acceptedCells;
+    if (enableFrustumCulling && useQuadtreeCulling)
+    {
+        quadtreeCuller.collect(maze, frustumCuller, windowX, windowZ, windowSize, windowSize, acceptedCells, cullCells);
+        cellsCulled += quadtreeCuller.getStats().cellsCulled;
+    }
+    else
+    {
+        maze.forEachFloorCell(windowX, windowZ, windowSize, windowSize, [&allCells](int x, int z)
+                              { allCells.push_back(glm::ivec2(x, z)); });
+    }
+
+    // Cells the camera can't see are dropped before any frustum test; returns how many went
+    auto keepVisible = [](const BitGrid &visible, int originX, int originZ)
+    {
+        int side = visible.getWidth();
+        auto hidden = [&](const glm::ivec2 &cell)
+        {
+            int x = cell.x - originX, z = cell.y - originZ;
+            return x < 0 || x >= side || z < 0 || z >= side || !visible.test(x, z);
+        };
+        size_t before = acceptedCells.size() + cullCells.size();
+        acceptedCells.erase(std::remove_if(acceptedCells.begin(), acceptedCells.end(), hidden), acceptedCells.end());
+        cullCells.erase(std::remove_if(cullCells.begin(), cullCells.end(), hidden), cullCells.end());
+        return static_cast<int>(before - acceptedCells.size() - cullCells.size());
+    };
+    if (const BitGrid *visible = cameraVisibility(maze))
+    {
+        glm::ivec2 cell = cameraCell(camera.Position);
+        cellsHiddenByPvs += keepVisible(*visible, cell.x - pvs.getRadius(), cell.y - pvs.getRadius());
+    }
+    if (enableOcclusionCulling)
+    {
+        // The window is centred on the camera's cell, so the render distance covers it
+        occlusionCuller.update(maze, camera.Position, renderDistance);
+        if (occlusionCuller.isValid())
+            cellsOccluded += keepVisible(occlusionCuller.getVisibility(), occlusionCuller.getOriginX(), occlusionCuller.getOriginZ());
+    }
+
+    // Cells in the frustum can still be behind the walls in the depth buffer
+    auto hiddenByDepth = [](const glm::ivec2 &cell)
+    {
+        if (!occlusionCuller.isAABBOccluded(cellBounds(cell.x, cell.y)))
+            return false;
+        cellsHiddenByDepth++;
+        return true;
+    };
+
+    for (const glm::ivec2 &cell : acceptedCells)
+    {
+        if (hiddenByDepth(cell))
+            continue;
+        cellsRendered++;
+        fn(cell.x, cell.y);
+    }
+    if (!enableFrustumCulling)
+        return;
+
+    cellsTested += static_cast<int>(cullCells.size());
+    cullBounds.clear();
+    for (const glm::ivec2 &cell : cullCells)
+        cullBounds.add(cellBounds(cell.x, cell.y));
+    frustumCuller.isAABBVisibleBatch(cullBounds, cullVisible);
+
+    for (size_t i = 0; i < cullCells.size(); ++i)
+    {
+        if (!((cullVisible[i / 64] >> (i % 64)) & 1))
+        {
+            cellsCulled++;
+            continue;
+        }
+        if (hiddenByDepth(cullCells[i]))
+            continue;
+        cellsRendered++;
+        fn(cullCells[i].x, cullCells[i].y);
+    }
+}
+
+template <typename Maze>
+void renderMaze(const Maze &maze, Shader &shader, Shader &lightShader, Mesh &wallMesh, Mesh &floorMesh, Mesh &ceilingMesh,
                 unsigned int wallTex, unsigned int floorTex, unsigned int ceilingTex)
 {
-    const float CELL_SIZE = 2.0f;
-    const float WALL_HEIGHT = 3.5f;
-    const float CEILING_TILE_SIZE = CELL_SIZE / 2.0f; // 4 ceiling tiles per cell (2x2)
-    const float WALL_OFFSET = CELL_SIZE * 0.5f;
-    const float HALF_WALL_HEIGHT = WALL_HEIGHT / 2.0f;
-    const float WALL_SCALE_Y = WALL_HEIGHT / 3.0f;
+    using namespace MazeGeometry;
     const glm::vec3 DARKER_WALL_COLOR = wallColor * 0.85f;
 
     glm::vec3 camPos = camera.Position;
-    int centerX = static_cast<int>(camPos.x / CELL_SIZE);
-    int centerZ = static_cast<int>(camPos.z / CELL_SIZE);
+    glm::ivec2 center = cameraCell(camPos);
+    int centerX = center.x, centerZ = center.y;
     int renderDistance = 18; // Slightly reduced for better performance
 
-    // Cache matrices for light shader to avoid recalculating
-    glm::mat4 lightProjection = glm::perspective(glm::radians(camera.Zoom), (float)currentWidth / (float)currentHeight, 0.1f, 100.0f);
-    glm::mat4 lightView = camera.GetViewMatrix();
+    // Per-program constants; uniform values live in the program object, so the queue only sets model and color
+    shader.use();
+    shader.setInt("texture1", 0);
+    lightShader.use();
+    lightShader.setFloat("intensity", ambientStrength * 15.0f + lightTileIntensity); // Linked to ambient
+
+    renderQueue.clear();
+    const int mazeProgram = renderQueue.addProgram(shader, "objectColor");
+    const int lightProgram = renderQueue.addProgram(lightShader, "lightColor");
 
-    for (int z = centerZ - renderDistance; z <= centerZ + renderDistance; ++z)
+    struct Material
     {
-        for (int x = centerX - renderDistance; x <= centerX + renderDistance; ++x)
+        int program;
+        unsigned int texture;
+        const Mesh *mesh;
+        glm::vec3 color;
+    };
+    std::array<Material, PIECE_COUNT> materials{};
+    materials[PIECE_FLOOR] = {mazeProgram, floorTex, &floorMesh, floorColor};
+    materials[PIECE_CEILING] = {mazeProgram, ceilingTex, &ceilingMesh, DARKER_WALL_COLOR};
+    materials[PIECE_LIGHT_TILE] = {lightProgram, 0, &ceilingMesh, lightTileColor};
+    materials[PIECE_WALL] = {mazeProgram, wallTex, &wallMesh, wallColor};
+
+    // Only floor cells are rendered; the cell views skip walls a 64-cell word at a time
+    auto submitCell = [&](int x, int z)
+    {
+        float depth = glm::length(glm::vec3(x * CELL_SIZE, HALF_WALL_HEIGHT, z * CELL_SIZE) - camPos);
+
+        auto submitPiece = [&](const PackedPiece &packed)
         {
-            if (!maze.isValidCell(x, z))
-                continue;
+            const Material &material = materials[packed.piece()];
+            renderQueue.submit(material.program, material.texture, *material.mesh, modelMatrix(packed, centerX, centerZ),
+                               material.color, depth);
+        };
+        forEachCellPiece(maze, x, z, submitPiece, centerX, centerZ);
+    };
+    forEachVisibleCell(maze, centerX, centerZ, renderDistance, submitCell);
+
+    renderQueue.flush();
+    drawCalls += renderQueue.getStats().draws;
+}
 
-            // Skip wall cells early - we only render floor cells
-            if (maze.isWall(x, z))
-                continue;
+void collectVisibleChunks(const ChunkMeshBuilder &chunkMeshes, std::vector<const ChunkMesh *> &visibleChunks)
+{
+    using namespace MazeGeometry;
+    const int renderDistance = 18; // Same cell radius as the per-cell path
 
-            glm::vec3 position(x * CELL_SIZE, 0.0f, z * CELL_SIZE);
+    glm::ivec2 center = cameraCell(camera.Position);
+    int centerX = center.x, centerZ = center.y;
 
-            // Frustum culling - create AABB for the cell
-            bool shouldRender = true;
-            if (enableFrustumCulling)
-            {
-                AABB cellAABB(
-                    glm::vec3(position.x - CELL_SIZE * 0.5f, 0.0f, position.z - CELL_SIZE * 0.5f),
-                    glm::vec3(position.x + CELL_SIZE * 0.5f, WALL_HEIGHT, position.z + CELL_SIZE * 0.5f));
-                shouldRender = frustumCuller.isAABBVisible(cellAABB);
+    visibleChunks.clear();
+    for (const auto &chunk : chunkMeshes.getChunks())
+    {
+        int startX = chunk.chunkX * MazeGenerator::CHUNK_SIZE;
+        int startZ = chunk.chunkZ * MazeGenerator::CHUNK_SIZE;
+        if (startX > centerX + renderDistance || startX + MazeGenerator::CHUNK_SIZE <= centerX - renderDistance ||
+            startZ > centerZ + renderDistance || startZ + MazeGenerator::CHUNK_SIZE <= centerZ - renderDistance)
+            continue;
+        visibleChunks.push_back(&chunk);
+    }
 
-                if (!shouldRender)
-                {
-                    cellsCulled++;
-                    continue;
-                }
-            }
+    if (!enableFrustumCulling)
+    {
+        chunksRendered += static_cast<int>(visibleChunks.size());
+        return;
+    }
 
-            cellsRendered++;
-            glm::mat4 model;
-            // Render floor (texture binding moved outside loop when possible)
-            shader.use();
-            glActiveTexture(GL_TEXTURE0);
-            glBindTexture(GL_TEXTURE_2D, floorTex);
-            shader.setInt("texture1", 0);
-
-            model = glm::mat4(1.0f);
-            model = glm::translate(model, position);
-            shader.setMat4("model", model);
-            shader.setVec3("objectColor", floorColor);
-            floorMesh.Draw(shader);
-
-            // Render 4 ceiling tiles (2x2 grid) - bind ceiling texture once
-            glBindTexture(GL_TEXTURE_2D, ceilingTex);
-
-            const float ceilingScale = CEILING_TILE_SIZE / CELL_SIZE;
-            for (int cz = 0; cz < 2; ++cz)
-            {
-                for (int cx = 0; cx < 2; ++cx)
-                {
-                    // Pre-calculate positions
-                    glm::vec3 ceilingTilePos = position + glm::vec3(
-                                                              (cx - 0.5f) * CEILING_TILE_SIZE,
-                                                              WALL_HEIGHT,
-                                                              (cz - 0.5f) * CEILING_TILE_SIZE);
-
-                    model = glm::mat4(1.0f);
-                    model = glm::translate(model, ceilingTilePos);
-                    model = glm::scale(model, glm::vec3(ceilingScale));
-
-                    // Check if this should be a light tile
-                    int globalCeilingX = (x * 2) + cx;
-                    int globalCeilingZ = (z * 2) + cz;
-
-                    if (globalCeilingX % 4 == 0 && globalCeilingZ % 3 == 0)
-                    {
-                        // Use light tile shader for visual effect only (use cached matrices)
-                        lightShader.use();
-                        lightShader.setMat4("projection", lightProjection);
-                        lightShader.setMat4("view", lightView);
-                        lightShader.setMat4("model", model);
-                        lightShader.setVec3("lightColor", lightTileColor);
-                        lightShader.setFloat("intensity", ambientStrength * 15.0f + lightTileIntensity); // Linked to ambient
-                        ceilingMesh.Draw(lightShader);
-                        shader.use();
-                    }
-                    else
-                    {
-                        shader.setMat4("model", model);
-                        shader.setVec3("objectColor", DARKER_WALL_COLOR);
-                        ceilingMesh.Draw(shader);
-                    }
-                }
-            }
+    // Frustum-test the chunks in range together, keeping the ones that pass (and aren't behind
+    // the walls in the depth buffer) in order
+    cullBounds.clear();
+    for (const ChunkMesh *chunk : visibleChunks)
+        cullBounds.add(chunk->bounds);
+    frustumCuller.isAABBVisibleBatch(cullBounds, cullVisible);
 
-            // Render walls (bind wall texture once)
-            glBindTexture(GL_TEXTURE_2D, wallTex);
-            shader.setVec3("objectColor", wallColor);
+    size_t kept = 0;
+    for (size_t i = 0; i < visibleChunks.size(); ++i)
+    {
+        if (((cullVisible[i / 64] >> (i % 64)) & 1) && !occlusionCuller.isAABBOccluded(visibleChunks[i]->bounds))
+            visibleChunks[kept++] = visibleChunks[i];
+    }
+    chunksRendered += static_cast<int>(kept);
+    chunksCulled += static_cast<int>(visibleChunks.size() - kept);
+    visibleChunks.resize(kept);
+}
 
-            // North wall (+Z)
-            if (maze.isWall(x, z + 1))
-            {
-                model = glm::mat4(1.0f);
-                model = glm::translate(model, position + glm::vec3(0.0f, HALF_WALL_HEIGHT, WALL_OFFSET));
-                model = glm::rotate(model, glm::radians(180.0f), glm::vec3(0.0f, 1.0f, 0.0f));
-                model = glm::scale(model, glm::vec3(1.0f, WALL_SCALE_Y, 1.0f));
-                shader.setMat4("model", model);
-                wallMesh.Draw(shader);
-            }
+void renderMazeChunks(const ChunkMeshBuilder &chunkMeshes, Shader &shader, Shader &lightShader,
+                      unsigned int wallTex, unsigned int floorTex, unsigned int ceilingTex)
+{
+    const glm::vec3 DARKER_WALL_COLOR = wallColor * 0.85f;
 
-            // South wall (-Z)
-            if (maze.isWall(x, z - 1))
-            {
-                model = glm::mat4(1.0f);
-                model = glm::translate(model, position + glm::vec3(0.0f, HALF_WALL_HEIGHT, -WALL_OFFSET));
-                model = glm::scale(model, glm::vec3(1.0f, WALL_SCALE_Y, 1.0f));
-                shader.setMat4("model", model);
-                wallMesh.Draw(shader);
-            }
+    // Pick visible chunks once, then draw them material by material so each texture is bound once per frame
+    static std::vector<const ChunkMesh *> visibleChunks;
+    collectVisibleChunks(chunkMeshes, visibleChunks);
 
-            // East wall (+X)
-            if (maze.isWall(x + 1, z))
-            {
-                model = glm::mat4(1.0f);
-                model = glm::translate(model, position + glm::vec3(WALL_OFFSET, HALF_WALL_HEIGHT, 0.0f));
-                model = glm::rotate(model, glm::radians(-90.0f), glm::vec3(0.0f, 1.0f, 0.0f));
-                model = glm::scale(model, glm::vec3(1.0f, WALL_SCALE_Y, 1.0f));
-                shader.setMat4("model", model);
-                wallMesh.Draw(shader);
-            }
+    // Geometry is already in world space
+    const glm::mat4 identity(1.0f);
 
-            // West wall (-X)
-            if (maze.isWall(x - 1, z))
-            {
-                model = glm::mat4(1.0f);
-                model = glm::translate(model, position + glm::vec3(-WALL_OFFSET, HALF_WALL_HEIGHT, 0.0f));
-                model = glm::rotate(model, glm::radians(90.0f), glm::vec3(0.0f, 1.0f, 0.0f));
-                model = glm::scale(model, glm::vec3(1.0f, WALL_SCALE_Y, 1.0f));
-                shader.setMat4("model", model);
-                wallMesh.Draw(shader);
-            }
+    shader.use();
+    shader.setMat4("model", identity);
+    shader.setInt("texture1", 0);
+    glActiveTexture(GL_TEXTURE0);
+
+    const struct
+    {
+        MazePiece piece;
+        unsigned int texture;
+        glm::vec3 color;
+    } materials[] = {
+        {PIECE_FLOOR, floorTex, floorColor},
+        {PIECE_CEILING, ceilingTex, DARKER_WALL_COLOR},
+        {PIECE_WALL, wallTex, wallColor}};
+
+    for (const auto &material : materials)
+    {
+        glBindTexture(GL_TEXTURE_2D, material.texture);
+        shader.setVec3("objectColor", material.color);
+        for (const ChunkMesh *chunk : visibleChunks)
+        {
+            if (chunk->Draw(material.piece))
+                drawCalls++;
         }
     }
+
+    lightShader.use();
+    lightShader.setMat4("model", identity);
+    lightShader.setVec3("lightColor", lightTileColor);
+    lightShader.setFloat("intensity", ambientStrength * 15.0f + lightTileIntensity); // Linked to ambient
+    for (const ChunkMesh *chunk : visibleChunks)
+    {
+        if (chunk->Draw(PIECE_LIGHT_TILE))
+            drawCalls++;
+    }
+
+    glBindVertexArray(0);
+}
+
+void renderMazeChunksArray(const ChunkMeshBuilder &chunkMeshes, Shader &arrayShader, unsigned int materialArray)
+{
+    static std::vector<const ChunkMesh *> visibleChunks;
+    collectVisibleChunks(chunkMeshes, visibleChunks);
+
+    bindMaterialArray(arrayShader, materialArray);
+
+    // One call per chunk covers floors, ceilings, light tiles and walls
+    for (const ChunkMesh *chunk : visibleChunks)
+    {
+        if (chunk->DrawAll())
+            drawCalls++;
+    }
+
+    glBindVertexArray(0);
+}
+
+void renderMazeChunksIndirect(Shader &arrayShader, unsigned int materialArray)
+{
+    using namespace MazeGeometry;
+    const int renderDistance = 18; // Same cell radius as the per-cell path
+
+    // Same cell window as collectVisibleChunks, as a world-space XZ box
+    glm::ivec2 center = cameraCell(camera.Position);
+    int centerX = center.x, centerZ = center.y;
+    glm::vec2 rangeMin((centerX - renderDistance) * CELL_SIZE - CELL_SIZE * 0.5f, (centerZ - renderDistance) * CELL_SIZE - CELL_SIZE * 0.5f);
+    glm::vec2 rangeMax((centerX + renderDistance) * CELL_SIZE + CELL_SIZE * 0.5f, (centerZ + renderDistance) * CELL_SIZE + CELL_SIZE * 0.5f);
+
+    gpuCuller.cull(frustumCuller, enableFrustumCulling, rangeMin, rangeMax);
+
+    // Counts come back a frame or more late so the CPU never waits on the GPU
+    int visible = gpuCuller.getVisibleCount();
+    if (visible >= 0)
+    {
+        chunksRendered = visible;
+        chunksCulled = gpuCuller.getChunkCount() - visible;
+    }
+
+    bindMaterialArray(arrayShader, materialArray);
+    gpuCuller.draw();
+    drawCalls++;
+}
+
+void bindMaterialArray(Shader &arrayShader, unsigned int materialArray)
+{
+    // Per-material parameters indexed by MazePiece, matching the vertex material attribute
+    const float layers[PIECE_COUNT] = {0.0f, 1.0f, 1.0f, 2.0f};
+    const glm::vec3 colors[PIECE_COUNT] = {floorColor, wallColor * 0.85f, lightTileColor, wallColor};
+    const float lightIntensity = ambientStrength * 15.0f + lightTileIntensity; // Linked to ambient
+
+    const MaterialArrayUniforms &uniforms = materialArrayUniforms;
+    arrayShader.use();
+    arrayShader.setMat4(uniforms.model, glm::mat4(1.0f)); // Geometry is already in world space
+    arrayShader.setInt(uniforms.materials, 0);
+    for (int piece = 0; piece < PIECE_COUNT; ++piece)
+    {
+        arrayShader.setFloat(uniforms.layer[piece], layers[piece]);
+        arrayShader.setVec3(uniforms.color[piece], colors[piece]);
+        arrayShader.setFloat(uniforms.emission[piece], piece == PIECE_LIGHT_TILE ? lightIntensity : 0.0f);
+    }
+
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, materialArray);
+}
+
+template <typename Maze>
+void renderMazeInstanced(const Maze &maze, Shader &shader, Shader &lightShader,
+                         unsigned int wallTex, unsigned int floorTex, unsigned int ceilingTex)
+{
+    using namespace MazeGeometry;
+    const glm::vec3 DARKER_WALL_COLOR = wallColor * 0.85f;
+    const int renderDistance = 18; // Same cell radius as the per-cell path
+
+    glm::ivec2 center = cameraCell(camera.Position);
+    int centerX = center.x, centerZ = center.y;
+
+    for (auto &batch : instanceBatches)
+        batch.clear();
+
+    auto collectPiece = [](const PackedPiece &piece)
+    {
+        instanceBatches[piece.piece()].add(piece);
+    };
+
+    // The cell walk only collects packed pieces, around the camera's cell so far-out cells of the
+    // infinite world still fit them; nothing is submitted until every batch is filled
+    forEachVisibleCell(maze, centerX, centerZ, renderDistance, [&](int x, int z)
+                       { forEachCellPiece(maze, x, z, collectPiece, centerX, centerZ); });
+    const glm::vec2 cellOrigin(static_cast<float>(centerX), static_cast<float>(centerZ));
+
+    shader.use();
+    shader.setInt("texture1", 0);
+    shader.setVec2("cellOrigin", cellOrigin);
+    glActiveTexture(GL_TEXTURE0);
+
+    const struct
+    {
+        MazePiece piece;
+        unsigned int texture;
+        glm::vec3 color;
+    } materials[] = {
+        {PIECE_FLOOR, floorTex, floorColor},
+        {PIECE_CEILING, ceilingTex, DARKER_WALL_COLOR},
+        {PIECE_WALL, wallTex, wallColor}};
+
+    for (const auto &material : materials)
+    {
+        glBindTexture(GL_TEXTURE_2D, material.texture);
+        shader.setVec3("objectColor", material.color);
+        instancesDrawn += static_cast<int>(instanceBatches[material.piece].size());
+        if (instanceBatches[material.piece].Draw())
+            drawCalls++;
+    }
+
+    lightShader.use();
+    lightShader.setVec2("cellOrigin", cellOrigin);
+    lightShader.setVec3("lightColor", lightTileColor);
+    lightShader.setFloat("intensity", ambientStrength * 15.0f + lightTileIntensity); // Linked to ambient
+    instancesDrawn += static_cast<int>(instanceBatches[PIECE_LIGHT_TILE].size());
+    if (instanceBatches[PIECE_LIGHT_TILE].Draw())
+        drawCalls++;
+
+    glBindVertexArray(0);
 }
 
 void processInput(GLFWwindow *window)
@@ -490,24 +1171,23 @@ void key_callback(GLFWwindow *window, int key, int, int action, int)
     }
 }
 
-void setupLighting(Shader &shader, const Camera &camera)
+// Writes the shared FrameData block once per frame; every attached program sees the result
+void updateFrameUniforms(const glm::mat4 &projection, const glm::mat4 &view, const Camera &camera)
 {
-    shader.setVec3("viewPos", camera.Position);
-    shader.setFloat("ambientStrength", ambientStrength);
-
-    if (enableFlashlight)
-    {
-        shader.setVec3("spotlight.position", camera.Position);
-        shader.setVec3("spotlight.direction", camera.Front);
-        shader.setFloat("spotlight.cutOff", glm::cos(glm::radians(flashlightAngle)));
-        shader.setFloat("spotlight.outerCutOff", glm::cos(glm::radians(flashlightAngle + 5.0f))); // 5 degree falloff
-        shader.setVec3("spotlight.color", 1.0f, 0.9f, 0.8f);
-        shader.setFloat("spotlight.intensity", flashlightIntensity);
-    }
-    else
-    {
-        shader.setFloat("spotlight.intensity", 0.0f);
-    }
+    FrameUniformData frame;
+    frame.projection = projection;
+    frame.view = view;
+    frame.viewPos = camera.Position;
+    frame.ambientStrength = ambientStrength;
+
+    frame.spotlight.position = camera.Position;
+    frame.spotlight.direction = camera.Front;
+    frame.spotlight.cutOff = glm::cos(glm::radians(flashlightAngle));
+    frame.spotlight.outerCutOff = glm::cos(glm::radians(flashlightAngle + 5.0f)); // 5 degree falloff
+    frame.spotlight.color = glm::vec3(1.0f, 0.9f, 0.8f);
+    frame.spotlight.intensity = enableFlashlight ? flashlightIntensity : 0.0f;
+
+    frameUniforms.update(frame);
 }
 
 void toggleFullscreen(GLFWwindow *window)
@@ -597,17 +1277,21 @@ void renderUI(const Camera &camera, MazeGenerator &maze, GLFWwindow *window)
         ImGui::Text("  - %s", player->isGrounded ? "On Ground" : "In Air");
 
         // Show if player is colliding with walls
-        bool colliding = player->CheckCollision(player->position, maze);
+        bool colliding = infiniteWorld ? player->CheckCollision(player->position, world)
+                                       : player->CheckCollision(player->position, maze);
         ImGui::Text("  - Collision: %s", colliding ? "YES" : "NO");
 
         // Debug: Show grid coordinates
-        const float CELL_SIZE = 2.0f; // Same as in renderMaze
-        int gridX = static_cast<int>(floor(player->position.x / CELL_SIZE + 0.5f));
-        int gridZ = static_cast<int>(floor(player->position.z / CELL_SIZE + 0.5f));
+        glm::ivec2 grid = MazeGeometry::cameraCell(player->position);
+        int gridX = grid.x, gridZ = grid.y;
         ImGui::Text("  - Grid Position: (%d, %d)", gridX, gridZ);
 
         // Show if current grid cell is a wall
-        if (gridX >= 0 && gridX < maze.getWidth() && gridZ >= 0 && gridZ < maze.getHeight())
+        if (infiniteWorld)
+        {
+            ImGui::Text("  - Current Cell: %s", world.isWall(gridX, gridZ) ? "WALL" : "Open");
+        }
+        else if (gridX >= 0 && gridX < maze.getWidth() && gridZ >= 0 && gridZ < maze.getHeight())
         {
             bool isWall = maze.isWall(gridX, gridZ);
             ImGui::Text("  - Current Cell: %s", isWall ? "WALL" : "Open");
@@ -621,18 +1305,78 @@ void renderUI(const Camera &camera, MazeGenerator &maze, GLFWwindow *window)
 
     // Culling Statistics
     ImGui::Text("Rendering Statistics:");
-    ImGui::Text("Cells Rendered: %d", cellsRendered);
-    ImGui::Text("Cells Culled: %d", cellsCulled);
-    if (cellsRendered + cellsCulled > 0)
+    ImGui::Text("Draw Calls: %d", drawCalls);
+    if (renderPath == RENDER_PATH_BAKED_CHUNKS)
     {
-        float cullPercentage = (float)cellsCulled / (float)(cellsRendered + cellsCulled) * 100.0f;
-        ImGui::Text("Culling Efficiency: %.1f%%", cullPercentage);
+        ImGui::Text("Chunks Rendered: %d", chunksRendered);
+        ImGui::Text("Chunks Culled: %d", chunksCulled);
+        ImGui::Text("Baked Triangles: %zu", chunkMeshes.getTriangleCount());
+        ImGui::Checkbox("Texture Array Materials", &useTextureArray);
+        if (gpuCuller.isReady())
+            ImGui::Checkbox("GPU Culling (Multi-Draw Indirect)", &useGpuCulling);
+        else
+            ImGui::TextDisabled("GPU Culling: requires OpenGL 4.3");
+    }
+    else
+    {
+        if (renderPath == RENDER_PATH_INSTANCED)
+            ImGui::Text("Instances Drawn: %d", instancesDrawn);
+        if (renderPath == RENDER_PATH_PER_CELL)
+        {
+            const RenderQueue::Stats &queueStats = renderQueue.getStats();
+            ImGui::Text("Program Binds: %d", queueStats.programBinds);
+            ImGui::Text("Texture Binds: %d", queueStats.textureBinds);
+            ImGui::Text("Mesh Binds: %d", queueStats.meshBinds);
+        }
+        ImGui::Text("Cells Rendered: %d", cellsRendered);
+        ImGui::Text("Cells Culled: %d", cellsCulled);
+        if (cellsRendered + cellsCulled > 0)
+        {
+            float cullPercentage = (float)cellsCulled / (float)(cellsRendered + cellsCulled) * 100.0f;
+            ImGui::Text("Culling Efficiency: %.1f%%", cullPercentage);
+        }
+        if (enableFrustumCulling && useQuadtreeCulling)
+        {
+            const QuadtreeCuller::Stats &treeStats = quadtreeCuller.getStats();
+            ImGui::Text("Quadtree Nodes: %d visited, %d culled, %d inside", treeStats.nodesVisited,
+                        treeStats.nodesCulled, treeStats.nodesInside);
+        }
+        ImGui::Text("Cells Tested Individually: %d", cellsTested);
+        if (usePvs && !infiniteWorld)
+            ImGui::Text("Cells Hidden by PVS: %d", cellsHiddenByPvs);
+        if (enableOcclusionCulling)
+            ImGui::Text("Cells Occluded: %d", cellsOccluded);
+        if (useDepthOcclusion)
+            ImGui::Text("Cells Hidden by Depth Buffer: %d", cellsHiddenByDepth);
+    }
+    ImGui::Separator();
+
+    // Render path selection
+    ImGui::Combo("Render Path", &renderPath, renderPathNames, RENDER_PATH_COUNT);
+    bool sortDraws = renderQueue.getSorting();
+    if (ImGui::Checkbox("Sort Draw Queue", &sortDraws))
+        renderQueue.setSorting(sortDraws);
+    bool greedyMerging = chunkMeshes.getGreedyMerging();
+    if (ImGui::Checkbox("Merge Coplanar Faces", &greedyMerging))
+    {
+        chunkMeshes.setGreedyMerging(greedyMerging);
+        mazeMeshDirty = true;
     }
     ImGui::Separator();
 
     // Culling Controls
     ImGui::Text("Culling Options:");
     ImGui::Checkbox("Enable Frustum Culling", &enableFrustumCulling);
+    ImGui::Checkbox("Hierarchical (Quadtree) Culling", &useQuadtreeCulling);
+    ImGui::Checkbox("Potentially Visible Set", &usePvs);
+    ImGui::Checkbox("Occlusion Culling (Exact Grid Visibility)", &enableOcclusionCulling);
+    ImGui::Checkbox("Software Occlusion (CPU Depth Buffer)", &useDepthOcclusion);
+    if (useDepthOcclusion)
+        ImGui::Text("Depth Buffer: %d polygons, %.3f ms", occlusionCuller.getOccluderPolygons(), occlusionCuller.getRasterMs());
+    if (pvs.isReady())
+        ImGui::Text("PVS: %.1f KB, built in %.0f ms", pvs.getMemoryUsage() / 1024.0, pvs.getBuildMs());
+    else if (pvs.isBuilding())
+        ImGui::Text("PVS: building (%.0f%%)", pvs.getProgress() * 100.0f);
     ImGui::Separator();
 
     // Display Settings
@@ -684,12 +1428,66 @@ void renderUI(const Camera &camera, MazeGenerator &maze, GLFWwindow *window)
     {
         maze = MazeGenerator(75, 75, std::time(nullptr));
         maze.generateMaze();
+        mazeMeshDirty = true;
+        pvsDirty = true;
     }
 
     if (ImGui::Button("Generate Backrooms Maze"))
     {
         maze = MazeGenerator(75, 75, std::time(nullptr));
         maze.generateBackroomsMaze();
+        mazeMeshDirty = true;
+        pvsDirty = true;
+    }
+    ImGui::Text("Maze Storage: %.1f KB", maze.getMemoryUsage() / 1024.0);
+
+    // Save/load the maze as a binary file; a loaded maze decodes its chunks as they are first read
+    static char mazePathBuffer[256] = "";
+    if (mazePathBuffer[0] == '\0')
+        std::snprintf(mazePathBuffer, sizeof(mazePathBuffer), "%s", mazeFilePath.c_str());
+    ImGui::InputText("Maze File", mazePathBuffer, sizeof(mazePathBuffer));
+    if (ImGui::Button("Save Maze"))
+        maze.save(mazePathBuffer);
+    ImGui::SameLine();
+    if (ImGui::Button("Load Maze") && maze.load(mazePathBuffer))
+    {
+        mazeMeshDirty = true;
+        pvsDirty = true;
+    }
+    if (!maze.isFullyDecoded())
+        ImGui::Text("Maze File: decoding chunks on demand");
+    ImGui::Separator();
+
+    // Infinite world: the player starts on the corridor crossing at the world origin
+    if (ImGui::Checkbox("Infinite World", &infiniteWorld))
+    {
+        glm::vec3 start = infiniteWorld ? glm::vec3(0.0f, 0.1f, 0.0f) : glm::vec3(50.0f, 0.1f, 50.0f);
+        player->position = start;
+        player->velocity = glm::vec3(0.0f);
+        player->camera->Position = player->GetCameraPosition();
+    }
+    if (infiniteWorld)
+    {
+        if (ImGui::Button("New World Seed"))
+            world = ChunkedWorld(static_cast<unsigned int>(std::time(nullptr)));
+        ImGui::Text("World Seed: %u", world.getSeed());
+
+        const ChunkStreamer::Stats &streamStats = chunkStreamer.getStats();
+        ImGui::Text("Resident Chunks: %zu (%.1f KB of %.0f KB budget)", world.getResidentChunks(),
+                    world.getMemoryUsage() / 1024.0, chunkStreamer.memoryBudget / 1024.0);
+        ImGui::Text("Stream Queue: %d queued, %d generating (%d threads)", streamStats.queued, streamStats.inFlight,
+                    chunkStreamer.getThreadCount());
+        ImGui::Text("Chunk Generation: %.3f ms avg, %.3f ms max", streamStats.generateMs, streamStats.generateMaxMs);
+        ImGui::Text("Request to Resident: %.2f ms avg, %.2f ms max", streamStats.latencyMs, streamStats.latencyMaxMs);
+        ImGui::Text("Chunks Generated: %d, Evicted: %d", streamStats.completedTotal, streamStats.evictedTotal);
+        ImGui::SliderInt("Stream Radius (chunks)", &chunkStreamer.radius, 1, 8);
+        ImGui::SliderInt("Prefetch Distance (chunks)", &chunkStreamer.prefetchDistance, 0, 8);
+        int budgetKB = static_cast<int>(chunkStreamer.memoryBudget / 1024);
+        if (ImGui::SliderInt("Memory Budget (KB)", &budgetKB, 16, 4096))
+            chunkStreamer.memoryBudget = static_cast<size_t>(budgetKB) * 1024;
+
+        if (renderPath == RENDER_PATH_BAKED_CHUNKS)
+            renderPath = RENDER_PATH_INSTANCED;
     }
 
     ImGui::End();
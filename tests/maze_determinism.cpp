@@ -0,0 +1,274 @@
+// Determinism test for maze generation (no GL). Hashes the cells produced by generateMaze(),
+// generateBackroomsMaze() and generateChunk() for fixed seeds and sizes and compares them with
+// the checked-in goldens, then checks that chunks come out the same whatever order and however
+// many threads they are generated with.
+//   maze_determinism_test GOLDEN_FILE [--update]
+// --update rewrites GOLDEN_FILE from the current generators; only use it for an intended change.
+#include "ChunkedWorld.h"
+#include "MazeGenerator.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// FNV-1a over the view's size and each cell's type and visited flag, row-major
+static uint64_t hashCells(const MazeGridView &view)
+{
+  uint64_t hash = 1469598103934665603ull;
+  auto mix = [&hash](uint64_t value)
+  {
+    hash ^= value;
+    hash *= 1099511628211ull;
+  };
+  mix(static_cast<uint64_t>(view.getWidth()));
+  mix(static_cast<uint64_t>(view.getHeight()));
+  for (int z = 0; z < view.getHeight(); ++z)
+  {
+    for (int x = 0; x < view.getWidth(); ++x)
+    {
+      mix(static_cast<uint64_t>(view.getCellType(x, z)));
+      mix(view.getCell(x, z).visited ? 1 : 0);
+    }
+  }
+  return hash;
+}
+
+static std::string hashString(uint64_t hash)
+{
+  char buffer[17];
+  std::snprintf(buffer, sizeof(buffer), "%016llx", static_cast<unsigned long long>(hash));
+  return buffer;
+}
+
+// Every chunk of the grid, in row-major order unless `order` says otherwise
+static void generateAllChunks(MazeGenerator &maze, const std::vector<int> &order)
+{
+  int chunksX = (maze.getWidth() + MazeGenerator::CHUNK_SIZE - 1) / MazeGenerator::CHUNK_SIZE;
+  for (int index : order)
+    maze.generateChunk(index % chunksX, index / chunksX);
+}
+
+static std::vector<int> rowMajor(const MazeGenerator &maze)
+{
+  int chunksX = (maze.getWidth() + MazeGenerator::CHUNK_SIZE - 1) / MazeGenerator::CHUNK_SIZE;
+  int chunksZ = (maze.getHeight() + MazeGenerator::CHUNK_SIZE - 1) / MazeGenerator::CHUNK_SIZE;
+  std::vector<int> order(chunksX * chunksZ);
+  for (size_t i = 0; i < order.size(); ++i)
+    order[i] = static_cast<int>(i);
+  return order;
+}
+
+// Golden entries are "<mode> <width>x<height> <seed> <hash>", keyed by everything but the hash
+static std::map<std::string, std::string> computeGoldens()
+{
+  const int sizes[][2] = {{75, 75}, {64, 96}, {200, 150}, {301, 301}, {1024, 1024}};
+  const unsigned int seeds[] = {1, 777, 12345};
+
+  std::map<std::string, std::string> hashes;
+  for (const auto &size : sizes)
+  {
+    for (unsigned int seed : seeds)
+    {
+      std::string suffix = " " + std::to_string(size[0]) + "x" + std::to_string(size[1]) + " " + std::to_string(seed);
+
+      MazeGenerator maze(size[0], size[1], seed);
+      maze.generateMaze();
+      hashes["maze" + suffix] = hashString(hashCells(maze.view()));
+
+      // The 1024x1024 case covers the span-based room stamping at a large size
+      MazeGenerator backrooms(size[0], size[1], seed);
+      backrooms.generateBackroomsMaze();
+      hashes["backrooms" + suffix] = hashString(hashCells(backrooms.view()));
+
+      MazeGenerator chunks(size[0], size[1], seed);
+      generateAllChunks(chunks, rowMajor(chunks));
+      hashes["chunks" + suffix] = hashString(hashCells(chunks.view()));
+    }
+  }
+  return hashes;
+}
+
+static bool readGoldens(const std::string &path, std::map<std::string, std::string> &goldens)
+{
+  std::ifstream file(path);
+  if (!file)
+    return false;
+
+  std::string line;
+  while (std::getline(file, line))
+  {
+    if (line.empty() || line[0] == '#')
+      continue;
+    std::istringstream fields(line);
+    std::string mode, size, seed, hash;
+    if (fields >> mode >> size >> seed >> hash)
+      goldens[mode + " " + size + " " + seed] = hash;
+  }
+  return true;
+}
+
+static bool writeGoldens(const std::string &path, const std::map<std::string, std::string> &hashes)
+{
+  std::ofstream file(path);
+  if (!file)
+    return false;
+  file << "# Cell hashes checked by maze_determinism_test: <mode> <width>x<height> <seed> <hash>\n";
+  for (const auto &entry : hashes)
+    file << entry.first << " " << entry.second << "\n";
+  return static_cast<bool>(file);
+}
+
+static int checkGoldens(const std::map<std::string, std::string> &hashes, const std::map<std::string, std::string> &goldens)
+{
+  int failures = 0;
+  for (const auto &entry : hashes)
+  {
+    auto golden = goldens.find(entry.first);
+    if (golden == goldens.end())
+    {
+      std::printf("FAIL %s: no golden hash (got %s)\n", entry.first.c_str(), entry.second.c_str());
+      failures++;
+    }
+    else if (golden->second != entry.second)
+    {
+      std::printf("FAIL %s: expected %s, got %s\n", entry.first.c_str(), golden->second.c_str(), entry.second.c_str());
+      failures++;
+    }
+  }
+  for (const auto &golden : goldens)
+  {
+    if (!hashes.count(golden.first))
+    {
+      std::printf("FAIL %s: golden hash has no matching case\n", golden.first.c_str());
+      failures++;
+    }
+  }
+  std::printf("%s golden hashes: %zu cases, %d failures\n", failures ? "FAIL" : "ok  ", hashes.size(), failures);
+  return failures;
+}
+
+// Chunks generated in row-major, reversed and shuffled order into one grid must be identical
+static int checkChunkOrder(unsigned int seed)
+{
+  MazeGenerator reference(160, 128, seed);
+  std::vector<int> order = rowMajor(reference);
+  generateAllChunks(reference, order);
+  uint64_t expected = hashCells(reference.view());
+
+  int failures = 0;
+  std::vector<int> reversed(order.rbegin(), order.rend());
+  std::vector<int> shuffled = order;
+  std::shuffle(shuffled.begin(), shuffled.end(), std::mt19937(seed));
+  const std::vector<int> *orders[] = {&reversed, &shuffled};
+  const char *names[] = {"reversed", "shuffled"};
+  for (int i = 0; i < 2; ++i)
+  {
+    // Generating everything twice also covers overwriting chunks that already hold cells
+    MazeGenerator maze(160, 128, seed);
+    generateAllChunks(maze, *orders[i]);
+    generateAllChunks(maze, *orders[i]);
+    if (hashCells(maze.view()) != expected)
+    {
+      std::printf("FAIL chunk order: %s order differs from row-major (seed %u)\n", names[i], seed);
+      failures++;
+    }
+  }
+  return failures;
+}
+
+// World chunks (negative coordinates included) built on 1..N threads, each thread taking an
+// interleaved share, must match the same chunks generated serially into one grid
+static int checkChunkThreads(unsigned int seed)
+{
+  const int RANGE = 6; // chunks -RANGE..RANGE-1 on each axis
+  const int SPAN = 2 * RANGE;
+
+  MazeGenerator reference(SPAN * ChunkedWorld::CHUNK_SIZE, SPAN * ChunkedWorld::CHUNK_SIZE, seed);
+  for (int chunkZ = -RANGE; chunkZ < RANGE; ++chunkZ)
+    for (int chunkX = -RANGE; chunkX < RANGE; ++chunkX)
+      reference.generateChunk(chunkX, chunkZ, chunkX + RANGE, chunkZ + RANGE);
+
+  std::vector<uint64_t> expected(SPAN * SPAN);
+  for (int i = 0; i < SPAN * SPAN; ++i)
+    expected[i] = hashCells(reference.chunkView(i % SPAN, i / SPAN));
+
+  int failures = 0;
+  for (int threadCount : {1, 2, 3, 8})
+  {
+    std::vector<uint64_t> hashes(SPAN * SPAN);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadCount; ++t)
+    {
+      threads.emplace_back([&, t]
+                           {
+        // Each thread walks its share back to front, so neighbours are built out of order
+        for (int i = SPAN * SPAN - 1 - t; i >= 0; i -= threadCount)
+        {
+          WorldChunk chunk = ChunkedWorld::generateChunk(seed, i % SPAN - RANGE, i / SPAN - RANGE);
+          hashes[i] = hashCells(chunk.view());
+        } });
+    }
+    for (std::thread &thread : threads)
+      thread.join();
+
+    if (hashes != expected)
+    {
+      std::printf("FAIL chunk threads: %d threads differ from serial generation (seed %u)\n", threadCount, seed);
+      failures++;
+    }
+  }
+  return failures;
+}
+
+int main(int argc, char **argv)
+{
+  if (argc < 2)
+  {
+    std::printf("Usage: %s GOLDEN_FILE [--update]\n", argv[0]);
+    return 2;
+  }
+  std::string goldenPath = argv[1];
+  bool update = argc > 2 && std::strcmp(argv[2], "--update") == 0;
+
+  // The generators log each maze they build; keep the report readable
+  std::cout.setstate(std::ios::failbit);
+
+  std::map<std::string, std::string> hashes = computeGoldens();
+  if (update)
+  {
+    if (!writeGoldens(goldenPath, hashes))
+    {
+      std::printf("Failed to write %s\n", goldenPath.c_str());
+      return 1;
+    }
+    std::printf("Wrote %zu golden hashes to %s\n", hashes.size(), goldenPath.c_str());
+    return 0;
+  }
+
+  std::map<std::string, std::string> goldens;
+  if (!readGoldens(goldenPath, goldens))
+  {
+    std::printf("Failed to read %s\n", goldenPath.c_str());
+    return 1;
+  }
+
+  int failures = checkGoldens(hashes, goldens);
+  int chunkFailures = 0;
+  for (unsigned int seed : {1u, 12345u})
+  {
+    chunkFailures += checkChunkOrder(seed);
+    chunkFailures += checkChunkThreads(seed);
+  }
+  std::printf("%s chunk order and thread independence: %d failures\n", chunkFailures ? "FAIL" : "ok  ", chunkFailures);
+
+  return failures + chunkFailures == 0 ? 0 : 1;
+}
@@ -0,0 +1,98 @@
+// Conservativeness test for the potentially visible set (no GL). For eyes scattered over every
+// floor cell of the mazes the renderer uses, every cell OcclusionCuller::update() finds visible
+// from the eye (exact, per eye) must be in the PVS of the eye's cell; the PVS may hold more.
+//   pvs_conservative_test
+#include "MazeGenerator.h"
+#include "MazeGeometry.h"
+#include "OcclusionCuller.h"
+#include "PotentiallyVisibleSet.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <thread>
+
+static const int PVS_RADIUS = 19;
+static const int EYES_PER_CELL = 4;
+
+// Returns the number of cells seen from some eye but missing from the eye cell's PVS
+static int checkMaze(const MazeGenerator &maze, const char *name)
+{
+  using namespace MazeGeometry;
+  PotentiallyVisibleSet pvs;
+  pvs.build(maze, PVS_RADIUS);
+  while (!pvs.isReady())
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+
+  OcclusionCuller culler;
+  std::mt19937 rng(7);
+  // Anywhere in the cell, right up to its edges
+  std::uniform_real_distribution<float> offset(-0.499f, 0.499f);
+  int eyes = 0, missing = 0;
+  long long seen = 0, potentiallySeen = 0;
+  maze.forEachFloorCell(0, 0, maze.getWidth(), maze.getHeight(), [&](int x, int z)
+                        {
+    for (int i = 0; i < EYES_PER_CELL; ++i)
+    {
+      glm::vec3 eye((x + offset(rng)) * CELL_SIZE, 1.0f, (z + offset(rng)) * CELL_SIZE);
+      culler.update(maze, eye, PVS_RADIUS);
+      const BitGrid *potentially = pvs.visibleFrom(x, z);
+      if (!culler.isValid() || !potentially)
+      {
+        missing++;
+        continue;
+      }
+      eyes++;
+      for (int pz = 0; pz < potentially->getHeight(); ++pz)
+        for (int px = 0; px < potentially->getWidth(); ++px)
+          potentiallySeen += potentially->test(px, pz);
+
+      const BitGrid &visible = culler.getVisibility();
+      for (int vz = 0; vz < visible.getHeight(); ++vz)
+      {
+        for (int vx = 0; vx < visible.getWidth(); ++vx)
+        {
+          if (!visible.test(vx, vz))
+            continue;
+          seen++;
+          int dx = culler.getOriginX() + vx - x, dz = culler.getOriginZ() + vz - z;
+          if (std::abs(dx) > PVS_RADIUS || std::abs(dz) > PVS_RADIUS ||
+              !potentially->test(dx + PVS_RADIUS, dz + PVS_RADIUS))
+          {
+            if (missing++ < 5)
+              std::printf("  %s: eye (%.3f, %.3f) sees cell (%d, %d), not in the PVS of (%d, %d)\n", name,
+                          eye.x / CELL_SIZE, eye.z / CELL_SIZE, x + dx, z + dz, x, z);
+          }
+        }
+      }
+    } });
+
+  std::printf("%s %s: %d eyes, %.1f cells seen per eye, %.1f in the PVS, %d missing\n", missing ? "FAIL" : "ok  ",
+              name, eyes, eyes ? static_cast<double>(seen) / eyes : 0.0,
+              eyes ? static_cast<double>(potentiallySeen) / eyes : 0.0, missing);
+  return missing;
+}
+
+int main()
+{
+  // The generators log each maze they build; keep the report readable
+  std::cout.setstate(std::ios::failbit);
+
+  int failures = 0;
+  for (unsigned int seed : {1u, 12345u})
+  {
+    char name[64];
+    MazeGenerator maze(75, 75, seed);
+    maze.generateMaze();
+    std::snprintf(name, sizeof(name), "maze, seed %u", seed);
+    failures += checkMaze(maze, name);
+
+    MazeGenerator backrooms(75, 75, seed);
+    backrooms.generateBackroomsMaze();
+    std::snprintf(name, sizeof(name), "backrooms, seed %u", seed);
+    failures += checkMaze(backrooms, name);
+  }
+  return failures == 0 ? 0 : 1;
+}